@@ -64,7 +64,11 @@ namespace app {
         if (birth_date.empty()) {
             throw std::invalid_argument("Дата рождения не указана");
         }
-        return pn.to_string() + " " + birth_date;
+        std::string key;
+        key.reserve(pn.last_name().size() + pn.first_name().size() + pn.middle_name().size() + birth_date.size() + 3);
+        key.append(pn.last_name()).append(" ").append(pn.first_name()).append(" ")
+           .append(pn.middle_name()).append(" ").append(birth_date);
+        return key;
     }
 
     inline void App::render_startup_dialog() {
@@ -211,12 +215,17 @@ namespace app {
             ui::layout::render_ui(*repo_, to_key);
 
         render_end();
+
+        // изменения кадра фиксируются в журнале одной записью
+        if (repo_loaded_)
+            repo_->commit_journal();
     }
 
+    // stop фиксирует последние изменения в журнале и дожидается фонового переноса журнала
+    // в базовые файлы; сами файлы при выходе не переписываются
     inline void App::stop() const {
         if (repo_loaded_ && repo_) {
-            repo_->save_student_repo(students_path_buf_);
-            repo_->save_grade_repo(grades_path_buf_);
+            repo_->close_journal();
         }
     }
 
@@ -0,0 +1,138 @@
+#ifndef INSPECTOR_H
+#define INSPECTOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "imgui.h"
+#include "app/ui/state/InspectorState.h"
+
+namespace app::ui::inspector {
+    template<typename Node>
+    int node_height(const Node *node) {
+        return node ? node->height : 0;
+    }
+
+    // tree_node рисует узел дерева как раскрывающийся элемент. ImGui вызывает отрисовку
+    // потомков только для раскрытых узлов, поэтому за кадр обходится лишь видимая часть
+    // дерева, сколько бы узлов в нем ни было
+    template<typename Node>
+    void tree_node(const Node *node, const char *side) {
+        std::ostringstream key;
+        key << node->key;
+
+        const bool leaf = node->left == nullptr && node->right == nullptr;
+        const int factor = node_height(node->right) - node_height(node->left);
+
+        ImGui::PushID(node);
+        const bool open = ImGui::TreeNodeEx("node", leaf ? ImGuiTreeNodeFlags_Leaf : 0,
+                                            "%s%s  [h=%d, b=%+d, узлов=%d, id=%d]",
+                                            side, key.str().c_str(), node->height, factor, node->size,
+                                            node->list.count());
+        if (open) {
+            if (node->left) tree_node(node->left, "L: ");
+            if (node->right) tree_node(node->right, "R: ");
+            ImGui::TreePop();
+        }
+        ImGui::PopID();
+    }
+
+    // tree_stats выводит сводку о форме дерева; min_height - высота идеально сбалансированного
+    // дерева с тем же числом узлов, для сравнения
+    inline void tree_stats(const AVLTreeStats &stats) {
+        const int min_height = stats.nodes ? static_cast<int>(std::ceil(std::log2(stats.nodes + 1.0))) : 0;
+
+        ImGui::Text("Узлов: %zu, id: %zu, листьев: %zu", stats.nodes, stats.ids, stats.leaves);
+        ImGui::Text("Высота: %d (минимально возможная %d)", stats.height, min_height);
+        ImGui::Text("Средняя глубина: %.2f", stats.average_depth);
+        ImGui::Text("Баланс -1 / 0 / +1: %zu / %zu / %zu", stats.balance[0], stats.balance[1], stats.balance[2]);
+    }
+
+    template<typename Tree>
+    void tree_inspector(const char *id, const Tree &tree, AVLTreeStats &stats, bool &stats_ready) {
+        ImGui::PushID(id);
+
+        ImGui::Text("Узлов: %d, высота: %d", tree.get_nodes_count(), tree.get_tree_height());
+        ImGui::SameLine();
+        if (ImGui::Button("Статистика")) {
+            stats = tree.stats();
+            stats_ready = true;
+        }
+        if (stats_ready) tree_stats(stats);
+
+        if (const auto *root = tree.get_root())
+            tree_node(root, "");
+        else
+            ImGui::Text("Дерево пусто");
+
+        ImGui::PopID();
+    }
+
+    inline ImU32 slot_color(const hash::detail::EntryStatus status, const size_t distance) {
+        if (status == hash::detail::EMPTY) return IM_COL32(60, 60, 60, 255);
+        if (status == hash::detail::DELETED) return IM_COL32(200, 160, 40, 255);
+
+        // от зеленого (ключ в домашней ячейке) к красному (kHotDistance проб и больше)
+        const float t = std::min(1.f, static_cast<float>(distance) / state::InspectorState::kHotDistance);
+        return IM_COL32(static_cast<int>(60 + 195 * t), static_cast<int>(200 - 160 * t), 60, 255);
+    }
+
+    // hash_heatmap рисует ячейки таблицы цветными квадратами. ImGuiListClipper отдает только
+    // видимые строки, поэтому расстояния пробирования считаются лишь для видимых ячеек
+    template<typename Table>
+    void hash_heatmap(const Table &table, state::InspectorState &state) {
+        ImGui::Text("Ёмкость: %zu, занято: %zu (%.0f%%)", table.capacity(), table.size(),
+                    table.capacity() ? 100.0 * table.size() / table.capacity() : 0.0);
+        ImGui::SameLine();
+        if (ImGui::Button("Кластеры")) {
+            state.probe_stats = table.probe_stats();
+            state.probe_stats_ready = true;
+        }
+
+        if (state.probe_stats_ready) {
+            const auto &stats = state.probe_stats;
+            ImGui::Text("Кластеров: %zu, самый длинный: %zu, удаленных ячеек: %zu",
+                        stats.clusters, stats.longest_cluster, stats.deleted);
+            ImGui::Text("Расстояние пробирования: среднее %.2f, максимальное %zu",
+                        stats.average_distance, stats.max_distance);
+        }
+
+        if (table.capacity() == 0) return;
+
+        constexpr float cell = state::InspectorState::kCellSize;
+        ImGui::BeginChild("Heatmap", ImVec2(0, 200), true);
+
+        const auto columns = static_cast<size_t>(std::max(1.f, ImGui::GetContentRegionAvail().x / cell));
+        const size_t rows = (table.capacity() + columns - 1) / columns;
+        auto *draw_list = ImGui::GetWindowDrawList();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows), cell);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const ImVec2 origin = ImGui::GetCursorScreenPos();
+                const size_t first = row * columns;
+                const size_t last = std::min(first + columns, table.capacity());
+
+                for (size_t i = first; i < last; ++i) {
+                    const ImVec2 min(origin.x + (i - first) * cell, origin.y);
+                    const ImVec2 max(min.x + cell - 1, min.y + cell - 1);
+                    const auto status = table.slot_status(i);
+                    const size_t distance = table.probe_distance(i);
+
+                    draw_list->AddRectFilled(min, max, slot_color(status, distance));
+                    if (ImGui::IsMouseHoveringRect(min, max))
+                        ImGui::SetTooltip("Ячейка %zu, сдвиг от домашней: %zu", i, distance);
+                }
+
+                ImGui::Dummy(ImVec2(columns * cell, cell));
+            }
+        }
+
+        ImGui::EndChild();
+    }
+}
+
+#endif //INSPECTOR_H
@@ -5,10 +5,12 @@
 #ifndef LAYOUT_H
 #define LAYOUT_H
 #include "imgui.h"
+#include "app/ui/inspector/Inspector.h"
 #include "app/ui/pop-up/GradePopUp.h"
 #include "app/ui/pop-up/StudentPopUp.h"
 #include "app/ui/pop-up/StudentGradePopUp.h"
 #include "app/ui/state/GradeState.h"
+#include "app/ui/state/InspectorState.h"
 #include "app/ui/state/StudentState.h"
 #include "app/ui/state/StudentGradeState.h"
 #include "app/ui/table/GradeTable.h"
@@ -33,18 +35,25 @@ namespace app::ui::layout {
         pop_up::student_del_popup(repo, state, to_key);
         pop_up::student_search_popup(repo, state, to_key);
 
-        Vector<model::Student> students;
-        size_t count = 0;
-        if (state.search_active && state.cached_found) {
-            students = state.cached;
-            count = 1;
+        // студенты выводятся прямо из справочника или из результата поиска, без копирования
+        const bool show_cached = state.search_active && state.cached_found;
+        std::span<const model::Student> students;
+        if (show_cached) {
+            students = {state.cached.data(), state.cached.size()};
         } else {
-            students = repo.students();
-            count = repo.student_repo_size();
+            students = repo.student_view();
         }
 
-        if (!students.empty() && count) {
-            table::student_table(students, state);
+        // строки справочника идут через перестановку по выбранному столбцу: она строится
+        // при первом щелчке по заголовку и дальше поддерживается справочником
+        const auto row_at = [&](const size_t i) -> const model::Student & {
+            if (show_cached || state.sort_column < 0) return students[i];
+            const auto order = repo.sorted_students(static_cast<repo::StudentColumn>(state.sort_column));
+            return students[table::sorted_row(order, state.sort_descending, i)];
+        };
+
+        if (!students.empty()) {
+            table::student_table(students.size(), row_at, state);
         } else if (state.search_active) {
             ImGui::Text("Студент не найден.");
         }
@@ -66,18 +75,21 @@ namespace app::ui::layout {
         pop_up::grade_del_popup(repo, state, to_key);
         pop_up::grade_search_popup(repo, state, to_key);
 
-        Vector<model::Grade> grades;
-        size_t count = 0;
-        if (state.search_active && state.cached_found) {
-            grades = state.cached;
-            count = state.cached.size();
-        } else {
-            grades = repo.grades();
-            count = repo.grade_repo_size();
-        }
-
-        if (!grades.empty() && count) {
-            table::grade_table(grades, state);
+        // результат поиска показывается прямо из состояния, весь справочник - из хранилища
+        // через GradeView; ни то ни другое не копируется
+        const bool show_cached = state.search_active && state.cached_found;
+        const size_t count = show_cached ? state.cached.size() : repo.grade_repo_size();
+
+        if (count != 0 && show_cached) {
+            const auto &cached = state.cached;
+            table::grade_table(count, [&](const size_t i) -> const model::Grade & { return cached[i]; }, state);
+        } else if (count != 0) {
+            // строки справочника идут через перестановку по выбранному столбцу
+            table::grade_table(count, [&](const size_t i) {
+                if (state.sort_column < 0) return repo.grade_view(i);
+                const auto order = repo.sorted_grades(static_cast<repo::GradeColumn>(state.sort_column));
+                return repo.grade_view(table::sorted_row(order, state.sort_descending, i));
+            }, state);
         } else if (state.search_active) {
             ImGui::Text("Оценки не найдены.");
         }
@@ -129,6 +141,21 @@ namespace app::ui::layout {
             }
         }
 
+        ImGui::SameLine();
+        if (ImGui::Button("Статистика")) {
+            try {
+                state.period_stats = repo.grade_stats(
+                    model::Date::parse(state.start),
+                    model::Date::parse(state.end)
+                );
+                state.stats_applied = true;
+            } catch (const std::invalid_argument &e) {
+                state.stats_applied = false;
+                state.filter_err = true;
+                state.err_details = e.what();
+            }
+        }
+
         ImGui::SameLine();
         if (ImGui::Button("Сохранить")) {
             if (!state.filtered.empty()) state.open_save_dialog = true;
@@ -137,6 +164,13 @@ namespace app::ui::layout {
 
         pop_up::save_dialog_popup(repo, state);
 
+        if (state.stats_applied) {
+            const auto &stats = state.period_stats;
+            ImGui::Text("Оценок за период: %u, средний балл: %.2f", stats.count(), stats.average());
+            ImGui::Text("5: %u  4: %u  3: %u  2: %u  1: %u",
+                        stats.count(5), stats.count(4), stats.count(3), stats.count(2), stats.count(1));
+        }
+
         if (state.filter_applied && !state.filtered.empty())
             table::student_grade_table(state.filtered, state);
         else if (state.filter_applied)
@@ -170,15 +204,18 @@ namespace app::ui::layout {
         int index = 0;
         for (const auto &entry: get_log_entries()) {
             if (filter.PassFilter(entry.c_str())) {
-                std::string label = entry + "##" + std::to_string(index);
-                ImGui::Selectable(label.c_str());
+                // уникальность подписей дает стек идентификаторов ImGui, а не строки вида
+                // "запись##индекс", которые раньше собирались для каждой строки журнала на каждом кадре
+                ImGui::PushID(index);
+                ImGui::Selectable(entry.c_str());
 
-                if (ImGui::BeginPopupContextItem(("log_item_popup_" + std::to_string(index)).c_str())) {
+                if (ImGui::BeginPopupContextItem("log_item_popup")) {
                     if (ImGui::MenuItem("Скопировать строку")) {
                         ImGui::SetClipboardText(entry.c_str());
                     }
                     ImGui::EndPopup();
                 }
+                ImGui::PopID();
             }
             ++index;
         }
@@ -189,35 +226,64 @@ namespace app::ui::layout {
         ImGui::EndChild();
     }
 
-    inline void render_debug_tools(const repo::SchoolRepo &repo) {
+    // dump_button - кнопка вывода структуры в журнал; для больших структур недоступна,
+    // их нужно смотреть в инспекторе ниже
+    inline bool dump_button(const char *label, const bool allowed) {
+        ImGui::BeginDisabled(!allowed);
+        const bool pressed = ImGui::Button(label);
+        ImGui::EndDisabled();
+        if (!allowed && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            ImGui::SetTooltip("Структура слишком большая для вывода, используйте инспектор");
+        return pressed;
+    }
+
+    inline void render_debug_tools(const repo::SchoolRepo &repo, state::InspectorState &state) {
+        using state::InspectorState;
+
         ImGui::Text("Просмотр структур");
 
         ImGui::BeginChild("StructureViewButtons", ImVec2(0, 0), true, ImGuiWindowFlags_AlwaysUseWindowPadding);
 
-        if (ImGui::Button("Дерево дат")) {
+        const auto &date_tree = repo.date_tree();
+        const auto &key_tree = repo.key_tree();
+        const auto &table = repo.student_table();
+
+        if (dump_button("Дерево дат", static_cast<size_t>(date_tree.get_nodes_count()) <= InspectorState::kMaxDumpSize)) {
             Slog::info("\n" + repo.date_tree_structure());
         }
 
-        if (ImGui::Button("Горизонтальное дерево дат")) {
+        if (dump_button("Горизонтальное дерево дат", date_tree.get_tree_height() <= InspectorState::kMaxCanvasHeight)) {
             Slog::info("\n" + repo.date_tree_structure(true));
         }
 
-        if (ImGui::Button("Дерево ключей")) {
+        if (dump_button("Дерево ключей", static_cast<size_t>(key_tree.get_nodes_count()) <= InspectorState::kMaxDumpSize)) {
             Slog::info("\n" + repo.key_tree_structure());
         }
 
-        if (ImGui::Button("Горизонтальное дерево ключей")) {
+        if (dump_button("Горизонтальное дерево ключей", key_tree.get_tree_height() <= InspectorState::kMaxCanvasHeight)) {
             Slog::info("\n" + repo.key_tree_structure(true));
         }
 
-        if (ImGui::Button("Хеш-таблица")) {
+        if (dump_button("Хеш-таблица", table.size() <= InspectorState::kMaxDumpSize)) {
             Slog::info("\n" + repo.table_structure());
         }
 
-        if (ImGui::Button("Хеш-таблица полностью")) {
+        if (dump_button("Хеш-таблица полностью", table.capacity() <= InspectorState::kMaxDumpSize)) {
             Slog::info("\n" + repo.table_structure(false));
         }
 
+        if (ImGui::CollapsingHeader("Инспектор дерева дат")) {
+            inspector::tree_inspector("date_tree", date_tree, state.date_tree_stats, state.date_tree_stats_ready);
+        }
+
+        if (ImGui::CollapsingHeader("Инспектор дерева ключей")) {
+            inspector::tree_inspector("key_tree", key_tree, state.key_tree_stats, state.key_tree_stats_ready);
+        }
+
+        if (ImGui::CollapsingHeader("Тепловая карта хеш-таблицы")) {
+            inspector::hash_heatmap(table, state);
+        }
+
         ImGui::EndChild();
     }
 
@@ -285,6 +351,7 @@ namespace app::ui::layout {
         static state::StudentState student_state;
         static state::GradeState grade_state;
         static state::StudentGradeState filter_state;
+        static state::InspectorState inspector_state;
 
         const ImGuiViewport *vp = ImGui::GetMainViewport();
         ImGui::SetNextWindowPos(vp->Pos);
@@ -324,7 +391,7 @@ namespace app::ui::layout {
                             ImGuiWindowFlags_NoScrollbar |
                             ImGuiWindowFlags_NoScrollWithMouse |
                             ImGuiWindowFlags_NoTitleBar);
-                    render_debug_tools(repo);
+                    render_debug_tools(repo, inspector_state);
                 }
 
                 ImGui::SameLine(); {
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "model/Grade.h"
+#include "repository/Repository.h"
 
 namespace app::ui::state {
     struct GradeState {
@@ -32,7 +33,7 @@ namespace app::ui::state {
         // поиск / кеш
         bool search_active{};
         std::string search_key;
-        Vector<model::Grade> cached;
+        repo::GradeList cached;
         size_t step_counter;
 
         // ввод
@@ -44,6 +45,10 @@ namespace app::ui::state {
 
         // пагинация
         size_t current_page{};
+
+        // сортировка по столбцу таблицы; -1 - порядок хранилища
+        int sort_column = -1;
+        bool sort_descending{};
         bool cached_found;
     };
 }
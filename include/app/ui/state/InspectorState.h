@@ -0,0 +1,29 @@
+#ifndef INSPECTORSTATE_H
+#define INSPECTORSTATE_H
+
+#include "avl-tree/AVLTree.h"
+#include "hash/HashTable.h"
+
+namespace app::ui::state {
+    struct InspectorState {
+        // размер ячейки тепловой карты в пикселях
+        static constexpr float kCellSize = 8.f;
+        // расстояние пробирования, начиная с которого ячейка окрашивается в красный
+        static constexpr size_t kHotDistance = 8;
+        // горизонтальная схема дерева шириной 2^(h+1) - 1 ячеек строится только для низких деревьев
+        static constexpr int kMaxCanvasHeight = 6;
+        // текстовые дампы в журнал - только для небольших структур
+        static constexpr size_t kMaxDumpSize = 1024;
+
+        // статистика считается по кнопке, а не в каждом кадре
+        AVLTreeStats date_tree_stats;
+        AVLTreeStats key_tree_stats;
+        hash::ProbeStats probe_stats;
+
+        bool date_tree_stats_ready{};
+        bool key_tree_stats_ready{};
+        bool probe_stats_ready{};
+    };
+}
+
+#endif //INSPECTORSTATE_H
@@ -4,6 +4,7 @@
 
 #ifndef STUDENTGRADESTATE_H
 #define STUDENTGRADESTATE_H
+#include "model/GradeStats.h"
 #include "model/StudentGrade.h"
 
 namespace app::ui::state {
@@ -25,6 +26,10 @@ namespace app::ui::state {
         bool filter_applied = false;
         size_t step_counter;
 
+        // статистика оценок за период
+        model::GradeStats period_stats;
+        bool stats_applied{};
+
         // неверный ввод
         bool filter_err{};
         std::string err_details;
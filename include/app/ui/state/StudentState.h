@@ -40,6 +40,10 @@ namespace app::ui::state {
 
         // пагинация
         size_t current_page{};
+
+        // сортировка по столбцу таблицы; -1 - порядок хранилища
+        int sort_column = -1;
+        bool sort_descending{};
     };
 }
 #endif //STUDENTUISTATE_H
\ No newline at end of file
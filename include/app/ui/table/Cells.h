@@ -0,0 +1,54 @@
+#ifndef CELLS_H
+#define CELLS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "imgui.h"
+#include "model/Date.h"
+#include "model/PersonName.h"
+
+namespace app::ui::table {
+    // Ячейки таблиц выводят поля моделей по ссылкам и через буферы на стеке,
+    // не собирая временных строк на каждую строку каждого кадра
+
+    inline void text_cell(const std::string &text) {
+        ImGui::TextUnformatted(text.data(), text.data() + text.size());
+    }
+
+    inline void name_cell(const model::PersonName &name) {
+        ImGui::Text("%s %s %s", name.last_name().c_str(), name.first_name().c_str(), name.middle_name().c_str());
+    }
+
+    inline void date_cell(const model::Date &date) {
+        char buf[16];
+        const size_t len = date.write(buf);
+        ImGui::TextUnformatted(buf, buf + len);
+    }
+
+    // read_sort_specs переносит выбранную в заголовке сортировку в состояние таблицы:
+    // column - номер столбца или -1, если строки идут в порядке хранилища
+    inline void read_sort_specs(int &column, bool &descending) {
+        ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs();
+        if (specs == nullptr || !specs->SpecsDirty) return;
+
+        if (specs->SpecsCount == 0) {
+            column = -1;
+            descending = false;
+        } else {
+            column = specs->Specs[0].ColumnIndex;
+            descending = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+        }
+        specs->SpecsDirty = false;
+    }
+
+    // sorted_row переводит номер строки таблицы в индекс хранилища через перестановку order
+    // по возрастанию столбца; по убыванию перестановка читается с конца
+    inline size_t sorted_row(const std::span<const std::uint32_t> order, const bool descending, const size_t i) {
+        return order[descending ? order.size() - 1 - i : i];
+    }
+}
+
+#endif //CELLS_H
@@ -4,13 +4,20 @@
 
 #ifndef GRADETABLE_H
 #define GRADETABLE_H
+#include <cstddef>
+
 #include "imgui.h"
+#include "Cells.h"
 #include "app/ui/modal/CommonModal.h"
 #include "app/ui/state/GradeState.h"
 #include "model/Grade.h"
 
 namespace app::ui::table {
-    inline void grade_table(const Vector<model::Grade> &arr, state::GradeState &state) {
+    // grade_table выводит count оценок; row_at(i) возвращает i-ю оценку - Grade или
+    // model::GradeView, - поэтому строки справочника выводятся прямо из хранилища,
+    // без сборки массива оценок на каждый кадр
+    template<typename RowAt>
+    void grade_table(const size_t count, RowAt &&row_at, state::GradeState &state) {
         if (state.search_active) {
             if (!state.cached_found) {
                 ImGui::Text("Ничего не найдено.");
@@ -22,7 +29,7 @@ namespace app::ui::table {
             }
         }
 
-        const size_t pages = (arr.size() + state::GradeState::kPageSize - 1) / state::GradeState::kPageSize;
+        const size_t pages = (count + state::GradeState::kPageSize - 1) / state::GradeState::kPageSize;
         if (pages > 1) {
             if (ImGui::Button("<<") && state.current_page > 0) --state.current_page;
             ImGui::SameLine();
@@ -34,13 +41,15 @@ namespace app::ui::table {
         // TODO: проверить ломается ли пагинация: 2 листа, удаляем элемент, становится 1 лист
 
         const size_t first = state.current_page * state::GradeState::kPageSize;
-        const size_t last = std::min(first + state::GradeState::kPageSize, arr.size());
+        const size_t last = std::min(first + state::GradeState::kPageSize, count);
 
-        if (first >= arr.size())
+        if (first >= count)
             state.current_page = 0;
 
+        // третий щелчок по заголовку снимает сортировку и возвращает порядок хранилища
         constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
-                                          ImGuiTableFlags_SizingStretchProp;
+                                          ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_Sortable |
+                                          ImGuiTableFlags_SortTristate;
 
         if (ImGui::BeginTable("GradesTable", 5, flags)) {
             ImGui::TableSetupColumn("Студент", ImGuiTableColumnFlags_WidthStretch, 2.3f);
@@ -49,20 +58,21 @@ namespace app::ui::table {
             ImGui::TableSetupColumn("Оценка", ImGuiTableColumnFlags_WidthStretch, 1.f);
             ImGui::TableSetupColumn("Дата оценки", ImGuiTableColumnFlags_WidthStretch, 1.5f);
             ImGui::TableHeadersRow();
+            read_sort_specs(state.sort_column, state.sort_descending);
 
             for (size_t i = first; i < last; ++i) {
-                const auto &g = arr[i];
+                const auto &g = row_at(i);
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
-                ImGui::Text("%s", g.get_student_name().to_string().c_str());
+                name_cell(g.get_student_name());
                 ImGui::TableSetColumnIndex(1);
-                ImGui::Text("%s", g.get_student_birth_date().to_string().c_str());
+                date_cell(g.get_student_birth_date());
                 ImGui::TableSetColumnIndex(2);
-                ImGui::Text("%s", g.get_subject().c_str());
+                text_cell(g.get_subject());
                 ImGui::TableSetColumnIndex(3);
                 ImGui::Text("%d", g.get_grade());
                 ImGui::TableSetColumnIndex(4);
-                ImGui::Text("%s", g.get_date().to_string().c_str());
+                date_cell(g.get_date());
             }
 
             ImGui::EndTable();
@@ -6,6 +6,7 @@
 #define STUDENTGRADETABLE_H
 
 #include "imgui.h"
+#include "Cells.h"
 #include "app/ui/state/StudentGradeState.h"
 #include "model/StudentGrade.h"
 
@@ -39,17 +40,17 @@ namespace app::ui::table {
                 const auto &sg = arr[i];
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
-                ImGui::Text("%s", sg.get_student_name().to_string().c_str());
+                name_cell(sg.get_student_name());
                 ImGui::TableSetColumnIndex(1);
-                ImGui::Text("%s", sg.get_class().c_str());
+                text_cell(sg.get_class());
                 ImGui::TableSetColumnIndex(2);
-                ImGui::Text("%s", sg.get_birth_date().to_string().c_str());
+                date_cell(sg.get_birth_date());
                 ImGui::TableSetColumnIndex(3);
-                ImGui::Text("%s", sg.get_subject().c_str());
+                text_cell(sg.get_subject());
                 ImGui::TableSetColumnIndex(4);
                 ImGui::Text("%d", sg.get_grade());
                 ImGui::TableSetColumnIndex(5);
-                ImGui::Text("%s", sg.get_grade_date().to_string().c_str());
+                date_cell(sg.get_grade_date());
             }
 
             ImGui::EndTable();
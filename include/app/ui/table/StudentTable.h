@@ -4,13 +4,18 @@
 
 #ifndef STUDENTTABLE_H
 #define STUDENTTABLE_H
+#include <cstddef>
 
 #include "imgui.h"
+#include "Cells.h"
 #include "app/ui/state/StudentState.h"
 #include "model/Student.h"
 
 namespace app::ui::table {
-    inline void student_table(Vector<model::Student> &arr, state::StudentState &state) {
+    // student_table выводит count студентов; row_at(i) возвращает i-го студента - из справочника
+    // в порядке выбранной сортировки или из результата поиска
+    template<typename RowAt>
+    void student_table(const size_t count, RowAt &&row_at, state::StudentState &state) {
         if (state.search_active) {
             if (!state.cached_found) {
                 ImGui::Text("Ничего не найдено.");
@@ -23,7 +28,7 @@ namespace app::ui::table {
         }
 
 
-        const size_t pages = (arr.size() + state::StudentState::kPageSize - 1) / state::StudentState::kPageSize;
+        const size_t pages = (count + state::StudentState::kPageSize - 1) / state::StudentState::kPageSize;
         if (pages > 1) {
             if (ImGui::Button("<<") && state.current_page) --state.current_page;
             ImGui::SameLine();
@@ -33,28 +38,31 @@ namespace app::ui::table {
         }
 
         const size_t first = state.current_page * state::StudentState::kPageSize;
-        const size_t last = std::min(first + state::StudentState::kPageSize, arr.size());
+        const size_t last = std::min(first + state::StudentState::kPageSize, count);
 
-        if (first >= arr.size())
+        if (first >= count)
             state.current_page = 0;
 
+        // третий щелчок по заголовку снимает сортировку и возвращает порядок хранилища
         constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
-                                          ImGuiTableFlags_SizingStretchProp;
+                                          ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_Sortable |
+                                          ImGuiTableFlags_SortTristate;
 
         if (ImGui::BeginTable("StudentsTable", 3, flags)) {
             ImGui::TableSetupColumn("ФИО", ImGuiTableColumnFlags_WidthStretch, 4.f);
             ImGui::TableSetupColumn("Класс", ImGuiTableColumnFlags_WidthStretch, 1.f);
             ImGui::TableSetupColumn("Дата рождения", ImGuiTableColumnFlags_WidthStretch, 2.f);
             ImGui::TableHeadersRow();
+            read_sort_specs(state.sort_column, state.sort_descending);
             for (size_t i = first; i < last; ++i) {
-                const model::Student &s = arr[i];
+                const model::Student &s = row_at(i);
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
-                ImGui::Text("%s", s.get_name().to_string().c_str());
+                name_cell(s.get_name());
                 ImGui::TableSetColumnIndex(1);
                 ImGui::Text("%d", s.get_class());
                 ImGui::TableSetColumnIndex(2);
-                ImGui::Text("%s", s.get_birth_date().to_string().c_str());
+                date_cell(s.get_birth_date());
             }
 
             ImGui::EndTable();
@@ -5,85 +5,240 @@
 #ifndef AVLTREE_H
 #define AVLTREE_H
 
+#include <array>
+#include <concepts>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <span>
+#include <sstream>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <cmath>
 #include "../list/List.h"
+#include "../vector/SmallVector.h"
+#include "../vector/Vector.h"
 
-template <typename T>
+// NoAggregate - агрегат по умолчанию, когда узлам не нужны дополнительные сводные данные
+struct NoAggregate {
+    NoAggregate &operator+=(const NoAggregate &) { return *this; }
+    NoAggregate &operator-=(const NoAggregate &) { return *this; }
+};
+
+// AVLTreeStats - сводка о форме дерева для отладочного инспектора
+struct AVLTreeStats {
+    size_t nodes = 0;
+    size_t ids = 0;
+    size_t leaves = 0;
+    int height = 0;
+    double average_depth = 0;
+    // количество узлов с показателем баланса -1, 0 и +1
+    size_t balance[3]{};
+};
+
+// AVLTree хранит в узлах ключ и список id. Если передан Agg, каждый узел дополнительно
+// хранит агрегат своих id (own) и агрегат всего поддерева (total). Agg должен поддерживать
+// += и -=; total пересчитывается вместе с высотой и размером при вставке, удалении
+// и поворотах, что позволяет считать агрегат по диапазону ключей за O(log n).
+// Узлы и их списки id выделяются из ресурса памяти дерева (по умолчанию - глобального)
+template <typename T, typename Agg = NoAggregate>
 class AVLTree {
     struct Node {
         T key;
         mutable int height;
+        // количество узлов в поддереве с корнем в этом узле
+        mutable int size;
         Node *left;
         Node *right;
         SLList<int> list;
+        // агрегат id этого узла и агрегат всего поддерева
+        Agg own{};
+        mutable Agg total{};
 
-        explicit Node(const T key) {
+        Node(const T key, std::pmr::memory_resource *resource) : list(resource) {
             this->key = key;
             left = right = nullptr;
             height = 1;
+            size = 1;
         }
     };
 
     Node *root = nullptr;
-    int nodes_count = 0;
+    std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+
+    Node *make_node(const T &key);
+    void free_node(Node *node);
 
     static int get_height(const Node *node);
+    static int get_size(const Node *node);
     static int balance_factor(const Node *node);
     static void update_height(const Node *node);
+    static void update_size(const Node *node);
+    static const Agg &get_total(const Node *node);
+    static void update_total(const Node *node);
     static Node* right_rotate(Node *node);
     static Node* left_rotate(Node *node);
     static Node* balance(Node *node);
-    Node* insert(Node *node, T key, int id);
+    Node* insert(Node *node, T key, int id, const Agg &contribution = Agg{});
 
-    template<typename Callback>
+    template<std::invocable Callback>
     Node* insert(Node *node, T key, int id, Callback&& visit);
     static Node* find_min_node(Node *node);
     static Node* find_max_node(Node *node);
     static Node* delete_min_node(Node *node);
     static Node* delete_max_node(Node *node);
-    static Node* delete_node(Node *node, T key, int id);
-    static Node* delete_node(Node *node, T key);
+    Node* delete_node(Node *node, T key, int id, const Agg &contribution = Agg{});
+    Node* delete_node(Node *node, T key);
     static void get_tree_in_order(const Node *node, int row, int col, int height, std::vector<std::vector<T>> &ans);
     static std::vector<std::vector<T>> tree_to_matrix(Node *node);
     static std::string structure(Node *node);
     static void print_pre_order(Node *node);
     static void print_in_order(Node *node);
-    static void fill_keys_in_order(Node *node, T* keys, size_t& index);
     static void print_post_order(Node *node);
     static void print_reverse_in_order(Node *node);
     void clear_tree(Node *node);
+    template<typename KeyAt, typename ContributionAt, typename IdAt>
+    void build_groups(size_t count, KeyAt &key_at, ContributionAt &contribution_at, IdAt &id_at);
+    template<typename KeyAt, typename ContributionAt, typename IdAt>
+    Node *build_range(const Vector<size_t> &starts, size_t lo, size_t hi, KeyAt &key_at,
+                      ContributionAt &contribution_at, IdAt &id_at);
+
+    // ZeroContribution - вклад по умолчанию для build_sorted
+    struct ZeroContribution {
+        Agg operator()(size_t) const { return Agg{}; }
+    };
 
     template<typename Callback>
     static Node * search_node(Node *node, T key, Callback&& visit);
     template<typename Callback>
     static Node * search_node(Node *node, T key, int id, Callback&& visit);
 
-    void inorder_to_array(Node* node, T* key_arr, SLList<int>* list_arr, int& index, int arr_length) const;
     void lying_tree(Node *node, std::ostringstream &oss, size_t space = 0) const;
     template<typename Callback>
-    void range_search(Node* node, T& low, T& high, Callback&& visit) const;
+    static void select_range(const Node *node, size_t &skip, size_t &count, Callback &&visit);
+    static size_t count_less(const Node *node, const T &key, bool inclusive);
+    static Agg aggregate_less(const Node *node, const T &key, bool inclusive);
 
 public:
+    // Iterator - двунаправленный итератор центрированного обхода. Путь от корня до текущего
+    // узла хранится в стеке фиксированного размера внутри итератора, поэтому обход не
+    // выделяет память и не требует указателей на родителя в узлах. Высота АВЛ-дерева не
+    // превышает 1.44 * log2(n), так что kMaxDepth узлов хватает для любого размера дерева.
+    // end() - пустой стек; декремент end() переходит к максимальному узлу
+    class Iterator {
+        static constexpr size_t kMaxDepth = 64;
+
+        const Node *root_ = nullptr;
+        std::array<const Node *, kMaxDepth> path_{};
+        size_t depth_ = 0;
+
+        friend class AVLTree;
+
+        explicit Iterator(const Node *root) : root_(root) {}
+
+        void push(const Node *node) { path_[depth_++] = node; }
+
+        // descend спускается от node до крайнего левого (или правого) узла поддерева
+        void descend(const Node *node, const bool to_left) {
+            while (node != nullptr) {
+                push(node);
+                node = to_left ? node->left : node->right;
+            }
+        }
+
+        // ascend поднимается, пока текущий узел - правый (или левый) потомок родителя
+        void ascend(const bool from_right) {
+            const Node *child = path_[--depth_];
+            while (depth_ > 0 && (from_right ? path_[depth_ - 1]->right : path_[depth_ - 1]->left) == child) {
+                child = path_[--depth_];
+            }
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Node *;
+        using reference = const Node &;
+
+        Iterator() = default;
+
+        reference operator*() const { return *path_[depth_ - 1]; }
+        pointer operator->() const { return path_[depth_ - 1]; }
+
+        Iterator &operator++() {
+            if (const Node *node = path_[depth_ - 1]; node->right != nullptr)
+                descend(node->right, true);
+            else
+                ascend(true);
+            return *this;
+        }
+
+        Iterator &operator--() {
+            if (depth_ == 0) {
+                descend(root_, false);
+                return *this;
+            }
+            if (const Node *node = path_[depth_ - 1]; node->left != nullptr)
+                descend(node->left, false);
+            else
+                ascend(false);
+            return *this;
+        }
+
+        Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+        Iterator operator--(int) { Iterator old = *this; --*this; return old; }
+
+        bool operator==(const Iterator &other) const {
+            if (depth_ == 0 || other.depth_ == 0) return depth_ == other.depth_;
+            return path_[depth_ - 1] == other.path_[other.depth_ - 1];
+        }
+    };
+
+    using reverse_iterator = std::reverse_iterator<Iterator>;
+
+    [[nodiscard]] Iterator begin() const;
+    [[nodiscard]] Iterator end() const;
+    [[nodiscard]] reverse_iterator rbegin() const;
+    [[nodiscard]] reverse_iterator rend() const;
+    [[nodiscard]] Iterator lower_bound(const T &key) const;
+
+    AVLTree() = default;
+    explicit AVLTree(std::pmr::memory_resource *resource);
+    // дерево владеет узлами: копирование запрещено, перемещение передает корень
+    AVLTree(const AVLTree &) = delete;
+    AVLTree &operator=(const AVLTree &) = delete;
+    AVLTree(AVLTree &&other) noexcept;
+    AVLTree &operator=(AVLTree &&other) noexcept;
+    ~AVLTree();
+
     [[nodiscard]] std::string structure() const;
     [[nodiscard]] std::string lying_tree() const;
     void insert(T key, int id);
+    void insert(T key, int id, const Agg &contribution);
 
-    template <typename Callback>
+    template <std::invocable Callback>
     void insert(T key, int id, Callback&& visit);
 
     void update(T key, const int *ids, size_t count);
     void replace(T key, int id_to_replace, int new_id);
     void del(T key, int id);
+    void del(T key, int id, const Agg &contribution);
     void del(T key);
     void print_pre_order() const;
     void print_in_order() const;
-    T* keys_in_order() const;
+    [[nodiscard]] Vector<T> keys_in_order() const;
     void print_post_order() const;
     void print_reverse_in_order() const;
     void clear();
 
+    template<typename KeyAt, typename ContributionAt = ZeroContribution>
+    void build_sorted(size_t count, KeyAt &&key_at, ContributionAt &&contribution_at = {});
+    template<typename KeyOf, typename ContributionAt = ZeroContribution>
+    void build_ordered(std::span<const std::uint32_t> order, KeyOf &&key_of, ContributionAt &&contribution_at = {});
+
     template<class Callback>
     const Node * search(T key, int id, Callback &&visit) const;
 
@@ -91,34 +246,74 @@ public:
     const Node * search(T key, Callback &&visit) const;
 
     template<typename Callback>
-    void range_search(T& low, T& high, Callback&& visit) const;
+    void range_search(const T& low, const T& high, Callback&& visit) const;
 
     [[nodiscard]] int get_nodes_count() const;
+    [[nodiscard]] int get_tree_height() const;
+    [[nodiscard]] const Node *get_root() const;
+    [[nodiscard]] AVLTreeStats stats() const;
+
+    const Node *select(size_t k) const;
+    [[nodiscard]] size_t rank(const T &key) const;
+    [[nodiscard]] size_t count_in_range(const T &low, const T &high) const;
+    template<typename Callback>
+    void select_range(size_t first, size_t count, Callback &&visit) const;
+
+    [[nodiscard]] Agg range_aggregate(const T &low, const T &high) const;
+    [[nodiscard]] const Agg &aggregate() const;
+
     bool operator==(const AVLTree &other) const;
 
+    // id узла с ключом key; обычно их немного, и они помещаются во встроенный буфер
     template<typename Callback>
-    int *to_arr(T key, size_t &count, Callback &&visit);
+    SmallVector<int, 16> to_arr(const T &key, Callback &&visit);
     [[nodiscard]] size_t list_size(T key);
 };
 
-template <typename T>
-int AVLTree<T>::get_height(const Node *node) {
+template <typename T, typename Agg>
+int AVLTree<T, Agg>::get_height(const Node *node) {
     return node ? node->height : 0;
 }
 
-template <typename T>
- int AVLTree<T>::balance_factor(const Node *node) {
+template <typename T, typename Agg>
+int AVLTree<T, Agg>::get_size(const Node *node) {
+    return node ? node->size : 0;
+}
+
+template <typename T, typename Agg>
+ int AVLTree<T, Agg>::balance_factor(const Node *node) {
     return get_height(node->right) - get_height(node->left);
 }
 
-template <typename T>
- void AVLTree<T>::update_height(const Node *node) {
+template <typename T, typename Agg>
+ void AVLTree<T, Agg>::update_height(const Node *node) {
     const int hl = get_height(node->left);
     const int hr = get_height(node->right);
 
     node->height = (hl > hr ? hl : hr) + 1;
 }
 
+// update_size пересчитывает размер поддерева; вызывается везде, где меняются потомки узла
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::update_size(const Node *node) {
+    node->size = get_size(node->left) + get_size(node->right) + 1;
+}
+
+template <typename T, typename Agg>
+const Agg &AVLTree<T, Agg>::get_total(const Node *node) {
+    static const Agg empty{};
+    return node ? node->total : empty;
+}
+
+// update_total пересчитывает агрегат поддерева по агрегатам потомков и собственному
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::update_total(const Node *node) {
+    Agg total = get_total(node->left);
+    total += node->own;
+    total += get_total(node->right);
+    node->total = total;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // Правое вращение используется когда разница высот R поддерева и b-поддерева равна 2
 // и высота C <= высота L
@@ -140,10 +335,10 @@ template <typename T>
 //    L     a
 //        C   R
 //
-// Далее обновляем высоты для поддеревьев а и b
+// Далее обновляем высоты и размеры для поддеревьев а и b
 /////////////////////////////////////////////////////////////////////////////////////////
-template <typename T>
-typename AVLTree<T>::Node* AVLTree<T>::right_rotate(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node* AVLTree<T, Agg>::right_rotate(Node *node) {
     Slog::info("Правый поворот в дереве");
     Node* temp = node->left;
     node->left = temp->right;
@@ -151,6 +346,10 @@ typename AVLTree<T>::Node* AVLTree<T>::right_rotate(Node *node) {
 
     update_height(node);
     update_height(temp);
+    update_size(node);
+    update_size(temp);
+    update_total(node);
+    update_total(temp);
 
     return temp;
 }
@@ -176,10 +375,10 @@ typename AVLTree<T>::Node* AVLTree<T>::right_rotate(Node *node) {
 //    a     R
 //  L   C
 //
-// Далее обновляем высоты для поддеревьев а и b
+// Далее обновляем высоты и размеры для поддеревьев а и b
 /////////////////////////////////////////////////////////////////////////////////////////
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::left_rotate(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::left_rotate(Node *node) {
     Slog::info("Левый поворот в дереве");
     Node* temp = node->right;
     node->right = temp->left;
@@ -187,14 +386,20 @@ typename AVLTree<T>::Node * AVLTree<T>::left_rotate(Node *node) {
 
     update_height(node);
     update_height(temp);
+    update_size(node);
+    update_size(temp);
+    update_total(node);
+    update_total(temp);
 
     return temp;
 }
 
 // Метод balance осуществляет левый-правый или правый-левый (большое левое, большое правое) повороты.
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::balance(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::balance(Node *node) {
     update_height(node);
+    update_size(node);
+    update_total(node);
 
     if (balance_factor(node) == 2) {
         Slog::info("Разница высот поддеревьев равна 2");
@@ -214,31 +419,66 @@ typename AVLTree<T>::Node * AVLTree<T>::balance(Node *node) {
     return node; // балансировка не нужна
 }
 
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::insert(Node *node, const T key, int id) {
-    if( !node ) { auto newNode = new Node(key); newNode->list.push_back(id); nodes_count += 1; return newNode; }
+template <typename T, typename Agg>
+AVLTree<T, Agg>::AVLTree(std::pmr::memory_resource *resource) : resource_(resource) {
+}
+
+template <typename T, typename Agg>
+AVLTree<T, Agg>::AVLTree(AVLTree &&other) noexcept
+    : root(std::exchange(other.root, nullptr)), resource_(other.resource_) {
+}
+
+template <typename T, typename Agg>
+AVLTree<T, Agg> &AVLTree<T, Agg>::operator=(AVLTree &&other) noexcept {
+    if (this != &other) {
+        clear();
+        root = std::exchange(other.root, nullptr);
+        resource_ = other.resource_;
+    }
+    return *this;
+}
+
+template <typename T, typename Agg>
+AVLTree<T, Agg>::~AVLTree() {
+    clear();
+}
+
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node *AVLTree<T, Agg>::make_node(const T &key) {
+    return std::pmr::polymorphic_allocator<>(resource_).new_object<Node>(key, resource_);
+}
+
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::free_node(Node *node) {
+    std::pmr::polymorphic_allocator<>(resource_).delete_object(node);
+}
+
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::insert(Node *node, const T key, int id, const Agg &contribution) {
+    if( !node ) { auto newNode = make_node(key); newNode->list.push_back(id); newNode->own = contribution; newNode->total = contribution; return newNode; }
 
     /////////////////
     if (key == node->key) {
         node->list.push_back(id);
+        node->own += contribution;
     }
     /////////////////
 
 
     if(key < node->key) {
-        node->left = insert(node->left,key, id);
+        node->left = insert(node->left,key, id, contribution);
     }
     else if(key > node->key) {
-        node->right = insert(node->right,key, id);
+        node->right = insert(node->right,key, id, contribution);
     }
 
     return balance(node);
 }
 
-template<typename T>
-template<typename Callback>
-typename AVLTree<T>::Node * AVLTree<T>::insert(Node *node, T key, int id, Callback &&visit) {
-    if( !node ) { auto newNode = new Node(key); newNode->list.push_back(id); nodes_count += 1; visit(); return newNode; }
+template <typename T, typename Agg>
+template<std::invocable Callback>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::insert(Node *node, T key, int id, Callback &&visit) {
+    if( !node ) { auto newNode = make_node(key); newNode->list.push_back(id); visit(); return newNode; }
 
     /////////////////
     if (key == node->key) {
@@ -260,20 +500,20 @@ typename AVLTree<T>::Node * AVLTree<T>::insert(Node *node, T key, int id, Callba
 
 // find_min_node осуществляет поиск минимального узла относительно дерева, для которого переданный узел
 // является корнем
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::find_min_node(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::find_min_node(Node *node) {
     return node->left ? find_min_node(node->left) : node;
 }
 
 // find_max_node осуществляет поиск максимального узла относительно дерева, для которого переданный узел
 // является корнем
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::find_max_node(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::find_max_node(Node *node) {
     return node->right ? find_max_node(node->right) : node;
 }
 
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::delete_min_node(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::delete_min_node(Node *node) {
     if (node->left == nullptr) {
         return node->right;
     }
@@ -283,8 +523,8 @@ typename AVLTree<T>::Node * AVLTree<T>::delete_min_node(Node *node) {
     return balance(node);
 }
 
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::delete_max_node(Node *node) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::delete_max_node(Node *node) {
     if (node->right == nullptr) {
         return node->left;
     }
@@ -294,23 +534,24 @@ typename AVLTree<T>::Node * AVLTree<T>::delete_max_node(Node *node) {
     return balance(node);
 }
 
-template <typename T>
-typename AVLTree<T>::Node * AVLTree<T>::delete_node(Node *node, T key, int id) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::delete_node(Node *node, T key, int id, const Agg &contribution) {
     if (!node) return nullptr;
 
     if (key < node->key)
-        node->left = delete_node(node->left,key,id);
+        node->left = delete_node(node->left,key,id,contribution);
     else if (key > node->key)
-        node->right = delete_node(node->right,key,id);
+        node->right = delete_node(node->right,key,id,contribution);
     else {
-        if (node->list.search(id) != nullptr) {
+        if (node->list.contains(id)) {
             node->list.del(id);
+            node->own -= contribution;
         }
 
         if (node->list.count() == 0) {
             Node* leftNode = node->left;
             Node* rightNode = node->right;
-            delete node;
+            free_node(node);
 
             if (!leftNode) return rightNode;
 
@@ -325,8 +566,8 @@ typename AVLTree<T>::Node * AVLTree<T>::delete_node(Node *node, T key, int id) {
     return balance(node);
 }
 
-template<typename T>
-typename AVLTree<T>::Node * AVLTree<T>::delete_node(Node *node, T key) {
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::delete_node(Node *node, T key) {
     if (!node) return nullptr;
 
     if (key < node->key)
@@ -336,7 +577,7 @@ typename AVLTree<T>::Node * AVLTree<T>::delete_node(Node *node, T key) {
     else {
         Node* leftNode = node->left;
         Node* rightNode = node->right;
-        delete node;
+        free_node(node);
 
         if (!leftNode) return rightNode;
 
@@ -350,8 +591,8 @@ typename AVLTree<T>::Node * AVLTree<T>::delete_node(Node *node, T key) {
     return balance(node);
 }
 
-template <typename T>
-void AVLTree<T>::get_tree_in_order(const Node *node, const int row, const int col, const int height, std::vector<std::vector<T>> &ans) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::get_tree_in_order(const Node *node, const int row, const int col, const int height, std::vector<std::vector<T>> &ans) {
     if (!node) { return; }
 
     const int offset = pow(2, height - row - 1);
@@ -367,8 +608,8 @@ void AVLTree<T>::get_tree_in_order(const Node *node, const int row, const int co
     }
 }
 
-template <typename T>
-std::vector<std::vector<T>> AVLTree<T>::tree_to_matrix(Node *node) {
+template <typename T, typename Agg>
+std::vector<std::vector<T>> AVLTree<T, Agg>::tree_to_matrix(Node *node) {
     const int height = get_height(node);
 
     const int rows = height + 1;
@@ -381,8 +622,8 @@ std::vector<std::vector<T>> AVLTree<T>::tree_to_matrix(Node *node) {
     return ans;
 }
 
-template <typename T>
-std::string AVLTree<T>::structure(Node *node) {
+template <typename T, typename Agg>
+std::string AVLTree<T, Agg>::structure(Node *node) {
     std::ostringstream oss;
 
     for (auto result = tree_to_matrix(node); auto &row : result) {
@@ -399,8 +640,8 @@ std::string AVLTree<T>::structure(Node *node) {
     return oss.str();
 }
 
-template<typename T>
-void AVLTree<T>::print_pre_order(Node *node) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_pre_order(Node *node) {
     if (node == nullptr) return;
 
     std::cout << node->key;
@@ -410,8 +651,8 @@ void AVLTree<T>::print_pre_order(Node *node) {
     printPreOrder(node->right == nullptr ? nullptr : node->right);
 }
 
-template<typename T>
-void AVLTree<T>::print_in_order(Node *node) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_in_order(Node *node) {
     if (node == nullptr) return;
 
     print_in_order(node->left == nullptr ? nullptr : node->left);
@@ -422,16 +663,8 @@ void AVLTree<T>::print_in_order(Node *node) {
     print_in_order(node->right == nullptr ? nullptr : node->right);
 }
 
-template<typename T>
-void AVLTree<T>::fill_keys_in_order(Node *node, T *keys, size_t &index) {
-    if (!node) return;
-    fill_keys_in_order(node->left, keys, index);
-    keys[index++] = node->key;
-    fill_keys_in_order(node->right, keys, index);
-}
-
-template<typename T>
-void AVLTree<T>::print_post_order(Node *node) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_post_order(Node *node) {
     if (node == nullptr) return;
 
     print_post_order(node->left == nullptr ? nullptr : node->left);
@@ -441,8 +674,8 @@ void AVLTree<T>::print_post_order(Node *node) {
     node->list.print();
 }
 
-template<typename T>
-void AVLTree<T>::print_reverse_in_order(Node *node) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_reverse_in_order(Node *node) {
     if (node == nullptr) return;
 
     print_reverse_in_order(node->right == nullptr ? nullptr : node->right);
@@ -453,17 +686,17 @@ void AVLTree<T>::print_reverse_in_order(Node *node) {
     print_reverse_in_order(node->left == nullptr ? nullptr : node->left);
 }
 
-template<typename T>
-void AVLTree<T>::clear_tree(Node *node) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::clear_tree(Node *node) {
     if (node == nullptr) return;
     clear_tree(node->left == nullptr ? nullptr : node->left);
     clear_tree(node->right == nullptr ? nullptr : node->right);
-    delete node;
+    free_node(node);
 }
 
-template<typename T>
+template <typename T, typename Agg>
 template<typename Callback>
-typename AVLTree<T>::Node * AVLTree<T>::search_node(Node *node, T key, Callback &&visit) {
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::search_node(Node *node, T key, Callback &&visit) {
     visit();
     if (node == nullptr || node->key == key) return node;
     if (key < node->key)
@@ -471,9 +704,9 @@ typename AVLTree<T>::Node * AVLTree<T>::search_node(Node *node, T key, Callback
     return search_node(node->right, key, visit);
 }
 
-template<typename T>
+template <typename T, typename Agg>
 template<typename Callback>
-typename AVLTree<T>::Node * AVLTree<T>::search_node(Node *node, T key, int id, Callback &&visit) {
+typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::search_node(Node *node, T key, int id, Callback &&visit) {
     visit();
     if (node == nullptr || node->key == key && node->list.count(id) > 0) return node;
     if (key < node->key)
@@ -482,8 +715,8 @@ typename AVLTree<T>::Node * AVLTree<T>::search_node(Node *node, T key, int id, C
 }
 
 // structure печатает дерево полностью, игнорируя нулевые значения переданного типа
-template<typename T>
-std::string AVLTree<T>::structure() const {
+template <typename T, typename Agg>
+std::string AVLTree<T, Agg>::structure() const {
     // return structure(this->root);
     const Node *root = this->root;
     if (!root) return {};
@@ -608,40 +841,48 @@ std::string AVLTree<T>::structure() const {
     return out.str();
 }
 
-template<typename T>
-std::string AVLTree<T>::lying_tree() const {
+template <typename T, typename Agg>
+std::string AVLTree<T, Agg>::lying_tree() const {
     std::ostringstream oss;
     lying_tree(this->root, oss);
     return oss.str();
 }
 
-template<typename T>
-void AVLTree<T>::insert(const T key, const int id) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::insert(const T key, const int id) {
     this->root = insert(this->root, key, id);
 }
 
-template<typename T>
-template<typename Callback>
-void AVLTree<T>::insert(T key, int id, Callback &&visit) {
+// insert добавляет id вместе с его вкладом в агрегат узла
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::insert(const T key, const int id, const Agg &contribution) {
+    this->root = insert(this->root, key, id, contribution);
+}
+
+template <typename T, typename Agg>
+template<std::invocable Callback>
+void AVLTree<T, Agg>::insert(T key, int id, Callback &&visit) {
     this->root = insert(this->root, key, id, visit);
 }
 
-template<typename T>
-void AVLTree<T>::update(T key, const int *ids, const size_t count) {
-    auto *node = search(key);
-    if (node == nullptr) return;
+// update заменяет список id узла целиком. Вклады новых id неизвестны, поэтому own и total
+// пересчитать нельзя - для деревьев с агрегатом метод недоступен
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::update(T key, const int *ids, const size_t count) {
+    static_assert(std::is_same_v<Agg, NoAggregate>, "update не пересчитывает агрегаты узлов");
 
-    SLList<int> new_list;
+    auto *node = search_node(this->root, key, []{});
+    if (node == nullptr) return;
 
+    node->list.clear();
     for (size_t i = 0; i < count; ++i) {
-        new_list.push_back(ids[i]);
+        node->list.push_back(ids[i]);
     }
-
-    node->list = new_list;
 }
 
-template<typename T>
-void AVLTree<T>::replace(T key, int id_to_replace, int new_id) {
+// replace меняет номер той же записи: ее вклад в агрегат не меняется, поэтому own и total остаются верными
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::replace(T key, int id_to_replace, int new_id) {
     auto *node = search_node(this->root, key, []{});
     if (node == nullptr) return;
 
@@ -650,196 +891,401 @@ void AVLTree<T>::replace(T key, int id_to_replace, int new_id) {
     node->list.add(new_id);
 }
 
-template<typename T>
-void AVLTree<T>::del(const T key, const int id) {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::del(const T key, const int id) {
     this->root = delete_node(this->root, key, id);
 }
 
-template<typename T>
-void AVLTree<T>::del(T key) {
+// del удаляет id и вычитает его вклад из агрегата узла; contribution должен совпадать
+// с переданным при вставке
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::del(const T key, const int id, const Agg &contribution) {
+    this->root = delete_node(this->root, key, id, contribution);
+}
+
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::del(T key) {
     this->root = delete_node(this->root, key);
 }
 
 // print_pre_order осуществляет прямой обход дерева
-template<typename T>
-void AVLTree<T>::print_pre_order() const {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_pre_order() const {
     print_pre_order(this->root);
 }
 
 // print_in_order осуществляет центрированный обход дерева
 // такой обход выводит элементы в отсортированном порядке
-template<typename T>
-void AVLTree<T>::print_in_order() const {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_in_order() const {
     print_in_order(this->root);
 }
 
-template<typename T>
-T *AVLTree<T>::keys_in_order() const {
-    if (this->root == nullptr)
-        return nullptr;
-
-    T *keys = new T[nodes_count];
-    size_t index = 0;
-    fill_keys_in_order(this->root, keys, index);
-
+// keys_in_order возвращает ключи в отсортированном порядке
+template <typename T, typename Agg>
+Vector<T> AVLTree<T, Agg>::keys_in_order() const {
+    Vector<T> keys;
+    keys.reserve(get_size(this->root));
+    for (const auto &node: *this) {
+        keys.push_back(node.key);
+    }
     return keys;
 }
 
 // print_post_order осуществляет обратный обход дерева
-template<typename T>
-void AVLTree<T>::print_post_order() const {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_post_order() const {
     print_post_order(this->root);
 }
 
 // print_reverse_in_order осуществляет центрированный обход дерева в обратном порядке
-template<typename T>
-void AVLTree<T>::print_reverse_in_order() const {
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::print_reverse_in_order() const {
     print_reverse_in_order(this->root);
 }
 
-template<typename T>
-void AVLTree<T>::clear() {
+// build_sorted строит дерево заново за O(n) по id 0..count-1, ключи которых key_at(id) идут
+// по неубыванию: подряд идущие равные ключи становятся одним узлом со списком id, а узлы
+// собираются в идеально сбалансированное дерево делением отрезка пополам, без поворотов.
+// contribution_at(id) - вклад id в агрегат узла. Если ключи не упорядочены - выбрасывается ошибка
+template <typename T, typename Agg>
+template<typename KeyAt, typename ContributionAt>
+void AVLTree<T, Agg>::build_sorted(const size_t count, KeyAt &&key_at, ContributionAt &&contribution_at) {
+    auto id_at = [](const size_t pos) { return pos; };
+    build_groups(count, key_at, contribution_at, id_at);
+}
+
+// build_ordered строит дерево так же, но id берутся из перестановки: order[k] - id с k-м
+// по возрастанию ключом key_of(id). Списки узлов получают id в порядке order, поэтому обход
+// построенного дерева повторяет перестановку, с которой оно было сохранено
+template <typename T, typename Agg>
+template<typename KeyOf, typename ContributionAt>
+void AVLTree<T, Agg>::build_ordered(const std::span<const std::uint32_t> order, KeyOf &&key_of,
+                                    ContributionAt &&contribution_at) {
+    auto key_at = [&](const size_t pos) -> decltype(auto) { return key_of(order[pos]); };
+    auto id_at = [&order](const size_t pos) { return static_cast<size_t>(order[pos]); };
+    build_groups(order.size(), key_at, contribution_at, id_at);
+}
+
+// build_groups делит позиции 0..count-1 на группы равных ключей и собирает из них дерево
+template <typename T, typename Agg>
+template<typename KeyAt, typename ContributionAt, typename IdAt>
+void AVLTree<T, Agg>::build_groups(const size_t count, KeyAt &key_at, ContributionAt &contribution_at, IdAt &id_at) {
+    Vector<size_t> starts;
+    for (size_t pos = 0; pos < count; ++pos) {
+        if (pos == 0 || key_at(pos - 1) < key_at(pos)) {
+            starts.push_back(pos);
+        } else if (key_at(pos) < key_at(pos - 1)) {
+            throw std::invalid_argument("Ключи для построения дерева не упорядочены");
+        }
+    }
+    starts.push_back(count);
+
+    clear();
+    this->root = build_range(starts, 0, starts.size() - 1, key_at, contribution_at, id_at);
+}
+
+// build_range строит поддерево из групп равных ключей [lo, hi); starts[g] - первая позиция группы g
+template <typename T, typename Agg>
+template<typename KeyAt, typename ContributionAt, typename IdAt>
+typename AVLTree<T, Agg>::Node *AVLTree<T, Agg>::build_range(const Vector<size_t> &starts, const size_t lo,
+                                                             const size_t hi, KeyAt &key_at,
+                                                             ContributionAt &contribution_at, IdAt &id_at) {
+    if (lo >= hi) return nullptr;
+
+    const size_t mid = lo + (hi - lo) / 2;
+    Node *node = make_node(key_at(starts[mid]));
+    for (size_t pos = starts[mid]; pos < starts[mid + 1]; ++pos) {
+        const size_t id = id_at(pos);
+        node->list.push_back(static_cast<int>(id));
+        node->own += contribution_at(id);
+    }
+
+    node->left = build_range(starts, lo, mid, key_at, contribution_at, id_at);
+    node->right = build_range(starts, mid + 1, hi, key_at, contribution_at, id_at);
+    update_height(node);
+    update_size(node);
+    update_total(node);
+    return node;
+}
+
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::clear() {
     if (this->root == nullptr) { return; }
     clear_tree(this->root->left);
     clear_tree(this->root->right);
-    delete this->root;
+    free_node(this->root);
     this->root = nullptr;
 }
 
-template<typename T>
+template <typename T, typename Agg>
 template<typename Callback>
-const typename AVLTree<T>::Node* AVLTree<T>::search(T key, const int id, Callback &&visit) const {
+const typename AVLTree<T, Agg>::Node* AVLTree<T, Agg>::search(T key, const int id, Callback &&visit) const {
     return search_node(this->root, key, id, visit);
 }
 
-template<typename T>
+template <typename T, typename Agg>
 template<typename Callback>
-const typename AVLTree<T>::Node * AVLTree<T>::search(T key, Callback &&visit) const {
+const typename AVLTree<T, Agg>::Node * AVLTree<T, Agg>::search(T key, Callback &&visit) const {
     return search_node(this->root, key, visit);
 }
 
-template<typename T>
+// range_search вызывает visit(list) для каждого узла с ключом в отрезке [low, high]:
+// итератор встает на первый подходящий ключ и идет вправо, пока ключ не больше high
+template <typename T, typename Agg>
 template<typename Callback>
-void AVLTree<T>::range_search(T &low, T &high, Callback &&visit) const {
-    return range_search(this->root, low, high, visit);
+void AVLTree<T, Agg>::range_search(const T &low, const T &high, Callback &&visit) const {
+    for (auto it = lower_bound(low), last = end(); it != last && !(high < it->key); ++it) {
+        visit(it->list);
+    }
 }
 
-template<typename T>
-int AVLTree<T>::get_nodes_count() const {
-    return nodes_count;
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Iterator AVLTree<T, Agg>::begin() const {
+    Iterator it(this->root);
+    it.descend(this->root, true);
+    return it;
 }
 
-template<typename T>
-void AVLTree<T>::inorder_to_array(Node *node, T *key_arr, SLList<int> *list_arr, int &index,
-                                  const int arr_length) const {
-    if (node == nullptr || index >= arr_length) {
-        return;
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Iterator AVLTree<T, Agg>::end() const {
+    return Iterator(this->root);
+}
+
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::reverse_iterator AVLTree<T, Agg>::rbegin() const {
+    return reverse_iterator(end());
+}
+
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::reverse_iterator AVLTree<T, Agg>::rend() const {
+    return reverse_iterator(begin());
+}
+
+// lower_bound возвращает итератор на первый узел с ключом не меньше key или end().
+// Стек заполняется путем поиска и обрезается до последнего узла, где спуск ушел влево
+template <typename T, typename Agg>
+typename AVLTree<T, Agg>::Iterator AVLTree<T, Agg>::lower_bound(const T &key) const {
+    Iterator it(this->root);
+    size_t found = 0;
+    for (const Node *node = this->root; node != nullptr;) {
+        it.push(node);
+        if (node->key < key) {
+            node = node->right;
+        } else {
+            found = it.depth_;
+            node = node->left;
+        }
     }
+    it.depth_ = found;
+    return it;
+}
 
-    inorder_to_array(node->left, key_arr, list_arr, index, arr_length);
+template <typename T, typename Agg>
+int AVLTree<T, Agg>::get_nodes_count() const {
+    return get_size(this->root);
+}
+
+template <typename T, typename Agg>
+int AVLTree<T, Agg>::get_tree_height() const {
+    return get_height(this->root);
+}
+
+// get_root дает доступ к корню только для чтения, чтобы инспектор мог раскрывать
+// узлы по одному, не обходя дерево целиком
+template <typename T, typename Agg>
+const typename AVLTree<T, Agg>::Node *AVLTree<T, Agg>::get_root() const {
+    return this->root;
+}
 
-    if (index < arr_length) {
-        key_arr[index] = node->key;
-        list_arr[index] = node->list;
-        index++;
+// stats обходит дерево итератором и собирает глубины, листья и показатели баланса
+template <typename T, typename Agg>
+AVLTreeStats AVLTree<T, Agg>::stats() const {
+    AVLTreeStats stats;
+    stats.height = get_height(this->root);
+
+    size_t total_depth = 0;
+    for (auto it = begin(), last = end(); it != last; ++it) {
+        ++stats.nodes;
+        stats.ids += it->list.count();
+        total_depth += it.depth_ - 1;
+        if (it->left == nullptr && it->right == nullptr) ++stats.leaves;
+
+        const int factor = balance_factor(&*it);
+        if (factor >= -1 && factor <= 1) ++stats.balance[factor + 1];
     }
 
-    inorder_to_array(node->right, key_arr, list_arr, index, arr_length);
+    if (stats.nodes > 0)
+        stats.average_depth = static_cast<double>(total_depth) / stats.nodes;
+
+    return stats;
 }
 
-template<typename T>
-void AVLTree<T>::lying_tree(Node *node, std::ostringstream &oss, size_t space) const {
-    if (node == nullptr)
-        return;
+// select возвращает k-й по порядку узел (с нуля) или nullptr, если k >= количества узлов.
+// Размеры поддеревьев позволяют спускаться сразу в нужную сторону за O(log n)
+template <typename T, typename Agg>
+const typename AVLTree<T, Agg>::Node *AVLTree<T, Agg>::select(size_t k) const {
+    const Node *node = this->root;
+    while (node != nullptr) {
+        const auto left_size = static_cast<size_t>(get_size(node->left));
+        if (k < left_size) {
+            node = node->left;
+        } else if (k == left_size) {
+            return node;
+        } else {
+            k -= left_size + 1;
+            node = node->right;
+        }
+    }
+    return nullptr;
+}
 
-    space += 2;
-    lying_tree(node->right, oss, space);
-    for (int i = 2; i < space; ++i)
-        oss << "  ";
-    oss << node->key << ": ";
-    oss << node->list.structure();
+// count_less считает узлы с ключом меньше key (или не больше, если inclusive)
+template <typename T, typename Agg>
+size_t AVLTree<T, Agg>::count_less(const Node *node, const T &key, const bool inclusive) {
+    size_t count = 0;
+    while (node != nullptr) {
+        if (node->key < key || (inclusive && node->key == key)) {
+            count += get_size(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return count;
+}
 
-    lying_tree(node->left, oss, space);
+// rank возвращает количество ключей меньше key, т.е. позицию key в отсортированном порядке
+template <typename T, typename Agg>
+size_t AVLTree<T, Agg>::rank(const T &key) const {
+    return count_less(this->root, key, false);
 }
 
-template<typename T>
-template<typename Callback>
-void AVLTree<T>::range_search(Node *node, T &low, T &high, Callback &&visit) const {
-    if (node == nullptr) return;
+// count_in_range возвращает количество ключей в отрезке [low, high] за O(log n)
+template <typename T, typename Agg>
+size_t AVLTree<T, Agg>::count_in_range(const T &low, const T &high) const {
+    if (high < low) return 0;
+    return count_less(this->root, high, true) - count_less(this->root, low, false);
+}
 
-    if (low < node->key)
-        range_search(node->left, low, high, visit);
+// aggregate_less считает агрегат узлов с ключом меньше key (или не больше, если inclusive):
+// на пути от корня к key суммируются левые поддеревья и сами узлы, оставшиеся левее key
+template <typename T, typename Agg>
+Agg AVLTree<T, Agg>::aggregate_less(const Node *node, const T &key, const bool inclusive) {
+    Agg result{};
+    while (node != nullptr) {
+        if (node->key < key || (inclusive && node->key == key)) {
+            result += get_total(node->left);
+            result += node->own;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return result;
+}
 
-    if (low <= node->key && node->key <= high)
-        visit(node->list);
+// range_aggregate возвращает агрегат всех id с ключами в отрезке [low, high] за O(log n),
+// не обращаясь к самим записям
+template <typename T, typename Agg>
+Agg AVLTree<T, Agg>::range_aggregate(const T &low, const T &high) const {
+    if (high < low) return Agg{};
+    Agg result = aggregate_less(this->root, high, true);
+    result -= aggregate_less(this->root, low, false);
+    return result;
+}
 
-    if (node->key < high)
-        range_search(node->right, low, high, visit);
+// aggregate возвращает агрегат всего дерева
+template <typename T, typename Agg>
+const Agg &AVLTree<T, Agg>::aggregate() const {
+    return get_total(this->root);
 }
 
-template<typename T>
-bool AVLTree<T>::operator==(const AVLTree &other) const {
-    const int size1 = this->get_nodes_count();
-    const int size2 = other.get_nodes_count();
+// select_range обходит по порядку count узлов начиная с first-го и вызывает
+// visit(key, list) для каждого. Поддеревья целиком левее first пропускаются по размеру,
+// поэтому страница из count ключей выбирается за O(log n + count)
+template <typename T, typename Agg>
+template<typename Callback>
+void AVLTree<T, Agg>::select_range(const size_t first, size_t count, Callback &&visit) const {
+    size_t skip = first;
+    select_range(this->root, skip, count, visit);
+}
 
-    if (size1 != size2) {
-        return false;
+template <typename T, typename Agg>
+template<typename Callback>
+void AVLTree<T, Agg>::select_range(const Node *node, size_t &skip, size_t &count, Callback &&visit) {
+    if (node == nullptr || count == 0) return;
+
+    const auto left_size = static_cast<size_t>(get_size(node->left));
+    if (skip < left_size)
+        select_range(node->left, skip, count, visit);
+    else
+        skip -= left_size;
+
+    if (count == 0) return;
+
+    if (skip == 0) {
+        visit(node->key, node->list);
+        --count;
+    } else {
+        --skip;
     }
 
-    T* keyArr1 = new T[size1];
-    auto* listArr1 = new SLList<int>[size1];
-    T* keyArr2 = new T[size2];
-    auto* listArr2 = new SLList<int>[size2];
+    select_range(node->right, skip, count, visit);
+}
 
-    int index1 = 0, index2 = 0;
+template <typename T, typename Agg>
+void AVLTree<T, Agg>::lying_tree(Node *node, std::ostringstream &oss, size_t space) const {
+    if (node == nullptr)
+        return;
 
-    inorder_to_array(this->root, keyArr1, listArr1, index1, size1);
+    space += 2;
+    lying_tree(node->right, oss, space);
+    for (int i = 2; i < space; ++i)
+        oss << "  ";
+    oss << node->key << ": ";
+    oss << node->list.structure();
 
-    inorder_to_array(other.root, keyArr2, listArr2, index2, size2);
+    lying_tree(node->left, oss, space);
+}
 
-    for (int i = 0; i < size1; ++i) {
-        if (keyArr1[i] != keyArr2[i] || listArr1[i] != listArr2[i]) {
-            delete[] keyArr1;
-            delete[] listArr1;
-            delete[] keyArr2;
-            delete[] listArr2;
+// operator== сравнивает деревья потоково: оба обходятся итераторами одновременно,
+// ключи и списки id сравниваются на месте без копирования
+template <typename T, typename Agg>
+bool AVLTree<T, Agg>::operator==(const AVLTree &other) const {
+    if (this->get_nodes_count() != other.get_nodes_count()) {
+        return false;
+    }
+
+    for (auto it = begin(), other_it = other.begin(), last = end(); it != last; ++it, ++other_it) {
+        if (it->key != other_it->key || it->list != other_it->list) {
             return false;
         }
     }
 
-    delete[] keyArr1;
-    delete[] listArr1;
-    delete[] keyArr2;
-    delete[] listArr2;
-
     return true;
 }
 
-template<typename T>
+template <typename T, typename Agg>
 template<typename Callback>
-int* AVLTree<T>::to_arr(T key, size_t &count, Callback&& visit) {
+SmallVector<int, 16> AVLTree<T, Agg>::to_arr(const T &key, Callback&& visit) {
+    SmallVector<int, 16> ids;
     auto *node = search(key, visit);
     if (node == nullptr) {
-        count = 0;
-        return nullptr;
-    }
-
-    count = node->list.count();
-    if (count == 0) {
-        return nullptr;
+        return ids;
     }
 
-    auto ids = new int[count];
-    for (int i = 0; i < count; ++i) {
-        ids[i] = node->list[i];
+    ids.reserve(node->list.count());
+    for (const int id: node->list) {
+        ids.push_back(id);
     }
 
     return ids;
 }
 
-template<typename T>
-size_t AVLTree<T>::list_size(T key) {
-    auto *node = search(key);
+template <typename T, typename Agg>
+size_t AVLTree<T, Agg>::list_size(T key) {
+    auto *node = search(key, []{});
     if (node == nullptr) return 0;
     return node->list.count();
 }
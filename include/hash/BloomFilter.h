@@ -0,0 +1,151 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <cstdint>
+#include <functional>
+
+#include "../vector/Vector.h"
+
+namespace hash {
+    /**
+    * @brief Блочный фильтр Блума
+    *
+    * Фильтр отвечает "ключа точно нет" или "ключ, возможно, есть". Все биты одного
+    * ключа лежат в одном блоке размером с линию кеша (8 слов по 64 бита), по одному биту
+    * в каждом слове, поэтому проверка касается одной линии кеша, а восемь независимых
+    * операций над словами компилятор векторизует.
+    *
+    * Удалить ключ из фильтра нельзя, поэтому erase() только считает удаления. Когда
+    * удалений или вставок сверх расчетного размера становится слишком много, доля ложных
+    * срабатываний растет и needs_rebuild() сообщает, что фильтр нужно перестроить.
+    */
+    template<typename Key>
+    class BloomFilter {
+        static constexpr size_t kWords = 8;
+        static constexpr size_t kBitsPerKey = 12;
+        static constexpr size_t kBlockBits = kWords * 64;
+
+        struct alignas(64) Block {
+            std::uint64_t words[kWords];
+        };
+
+        Vector<Block> blocks_{};
+        // сколько ключей фильтр рассчитан хранить
+        size_t expected_ = 0;
+        size_t inserted_ = 0;
+        size_t erased_ = 0;
+
+        static std::uint64_t hash(const Key &key);
+        [[nodiscard]] size_t block_index(std::uint64_t h) const;
+        static void make_masks(std::uint64_t h, std::uint64_t (&masks)[kWords]);
+
+    public:
+        explicit BloomFilter(size_t expected = 0);
+
+        void insert(const Key &key);
+        void erase();
+        [[nodiscard]] bool may_contain(const Key &key) const;
+
+        void reset(size_t expected);
+        [[nodiscard]] bool needs_rebuild() const;
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] size_t memory() const;
+    };
+
+    template<typename Key>
+    BloomFilter<Key>::BloomFilter(const size_t expected) {
+        reset(expected);
+    }
+
+    // hash перемешивает стандартный хеш (финализатор splitmix64), чтобы все 64 бита были
+    // пригодны и для выбора блока, и для выбора битов внутри блока
+    template<typename Key>
+    std::uint64_t BloomFilter<Key>::hash(const Key &key) {
+        std::uint64_t h = std::hash<Key>{}(key);
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    template<typename Key>
+    size_t BloomFilter<Key>::block_index(const std::uint64_t h) const {
+        // старшие 32 бита равномерно отображаются в [0, blocks_.size()) без деления
+        return static_cast<size_t>(((h >> 32) * static_cast<std::uint64_t>(blocks_.size())) >> 32);
+    }
+
+    template<typename Key>
+    void BloomFilter<Key>::make_masks(const std::uint64_t h, std::uint64_t (&masks)[kWords]) {
+        // младшие 32 бита умножаются на свою нечетную "соль" для каждого слова,
+        // старшие 6 бит произведения - номер бита в слове
+        static constexpr std::uint32_t salt[kWords] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+        const auto low = static_cast<std::uint32_t>(h);
+        for (size_t i = 0; i < kWords; ++i) {
+            masks[i] = std::uint64_t{1} << ((low * salt[i]) >> 26);
+        }
+    }
+
+    template<typename Key>
+    void BloomFilter<Key>::insert(const Key &key) {
+        const std::uint64_t h = hash(key);
+        std::uint64_t masks[kWords];
+        make_masks(h, masks);
+
+        auto &block = blocks_[block_index(h)];
+        for (size_t i = 0; i < kWords; ++i) {
+            block.words[i] |= masks[i];
+        }
+        ++inserted_;
+    }
+
+    template<typename Key>
+    void BloomFilter<Key>::erase() {
+        ++erased_;
+    }
+
+    template<typename Key>
+    bool BloomFilter<Key>::may_contain(const Key &key) const {
+        const std::uint64_t h = hash(key);
+        std::uint64_t masks[kWords];
+        make_masks(h, masks);
+
+        const auto &block = blocks_[block_index(h)];
+        std::uint64_t missing = 0;
+        for (size_t i = 0; i < kWords; ++i) {
+            missing |= masks[i] & ~block.words[i];
+        }
+        return missing == 0;
+    }
+
+    // reset очищает фильтр и перестраивает его под expected ключей
+    template<typename Key>
+    void BloomFilter<Key>::reset(const size_t expected) {
+        expected_ = expected < 64 ? 64 : expected;
+        const size_t blocks = (expected_ * kBitsPerKey + kBlockBits - 1) / kBlockBits;
+
+        blocks_ = Vector<Block>();
+        blocks_.resize(blocks);
+        inserted_ = 0;
+        erased_ = 0;
+    }
+
+    template<typename Key>
+    bool BloomFilter<Key>::needs_rebuild() const {
+        return inserted_ > expected_ || erased_ * 4 > inserted_;
+    }
+
+    template<typename Key>
+    size_t BloomFilter<Key>::size() const {
+        return inserted_ - erased_;
+    }
+
+    template<typename Key>
+    size_t BloomFilter<Key>::memory() const {
+        return blocks_.size() * sizeof(Block);
+    }
+}
+
+#endif //BLOOMFILTER_H
@@ -0,0 +1,408 @@
+#ifndef CONCURRENTHASHTABLE_H
+#define CONCURRENTHASHTABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include "../vector/Vector.h"
+
+namespace hash {
+    /**
+    * @brief Хеш-таблица для многопоточного чтения
+    *
+    * Открытая адресация с линейным пробированием. Ячейка хранит атомарный указатель на
+    * неизменяемый узел ключ-значение: вставка публикует новый узел, обновление подменяет
+    * узел целиком, удаление заменяет его меткой "удалено".
+    *
+    * Чтение не берет блокировок: читатель отмечается в счетчике своей эпохи и проходит
+    * по ячейкам. Писатели блокируют одну из Stripes полос (по хешу ключа), поэтому
+    * операции над одним ключом упорядочены, а свободные ячейки занимаются через CAS.
+    * Расширение блокирует все полосы, переносит указатели на узлы в новую таблицу и
+    * публикует ее; читатели в это время продолжают работать со старой.
+    *
+    * Вытесненные узлы и таблицы освобождаются только после того, как завершатся все
+    * читатели, начавшие работу до их вытеснения (двухфазные эпохи).
+    */
+    template<typename Key, typename Val, size_t Stripes = 64>
+    class ConcurrentHashTable {
+        struct Node {
+            const Key key;
+            const Val val;
+            const size_t hash;
+        };
+
+        struct Table {
+            size_t cap;
+            std::unique_ptr<std::atomic<Node *>[]> slots;
+
+            explicit Table(const size_t cap) : cap(cap), slots(new std::atomic<Node *>[cap]) {
+                for (size_t i = 0; i < cap; ++i) {
+                    slots[i].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        struct alignas(64) Stripe {
+            std::mutex mutex;
+        };
+
+        // счетчики активных читателей; читатели распределены по слотам, чтобы не
+        // делить одну линию кеша на все ядра
+        struct alignas(64) ReaderSlot {
+            std::atomic<size_t> active[2]{};
+        };
+
+        static constexpr size_t kReaderSlots = 64;
+        static constexpr size_t kReclaimThreshold = 64;
+
+        std::atomic<Table *> table_;
+        std::atomic<size_t> size_{0};
+        // занятые ячейки вместе с метками "удалено"
+        std::atomic<size_t> used_{0};
+
+        mutable std::array<Stripe, Stripes> stripes_{};
+
+        mutable std::array<ReaderSlot, kReaderSlots> readers_{};
+        std::atomic<unsigned> epoch_{0};
+
+        std::mutex reclaim_mutex_;
+        std::mutex retire_mutex_;
+        Vector<Node *> retired_nodes_;
+        Vector<Table *> retired_tables_;
+
+        static Node *tombstone() { return reinterpret_cast<Node *>(std::uintptr_t{1}); }
+
+        static size_t hash_of(const Key &key);
+        static size_t reader_slot();
+
+        std::mutex &stripe(size_t hash) const;
+
+        void grow_if_needed();
+        void retire(Node *node);
+        void retire(Table *table);
+        void reclaim();
+
+        class ReadGuard {
+            const ConcurrentHashTable &owner_;
+            size_t slot_;
+            unsigned epoch_;
+
+        public:
+            explicit ReadGuard(const ConcurrentHashTable &owner);
+            ~ReadGuard();
+        };
+
+    public:
+        explicit ConcurrentHashTable(size_t cap = 16);
+        ~ConcurrentHashTable();
+
+        ConcurrentHashTable(const ConcurrentHashTable &) = delete;
+        ConcurrentHashTable &operator=(const ConcurrentHashTable &) = delete;
+
+        bool insert(const Key &key, const Val &val);
+        bool update(const Key &key, const Val &val);
+        bool erase(const Key &key);
+
+        template<typename Callback>
+        bool find(const Key &key, Callback &&on_found) const;
+
+        [[nodiscard]] std::optional<Val> get(const Key &key) const;
+        [[nodiscard]] bool contains(const Key &key) const;
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] size_t capacity() const;
+        [[nodiscard]] bool empty() const;
+    };
+
+    template<typename Key, typename Val, size_t Stripes>
+    ConcurrentHashTable<Key, Val, Stripes>::ReadGuard::ReadGuard(const ConcurrentHashTable &owner)
+        : owner_(owner), slot_(reader_slot()) {
+        // если эпоха сменилась между чтением и отметкой, писатель мог нас не увидеть -
+        // отмечаемся заново в новой эпохе
+        for (;;) {
+            epoch_ = owner_.epoch_.load();
+            owner_.readers_[slot_].active[epoch_ & 1].fetch_add(1);
+            if (owner_.epoch_.load() == epoch_) break;
+            owner_.readers_[slot_].active[epoch_ & 1].fetch_sub(1);
+        }
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    ConcurrentHashTable<Key, Val, Stripes>::ReadGuard::~ReadGuard() {
+        owner_.readers_[slot_].active[epoch_ & 1].fetch_sub(1, std::memory_order_release);
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    ConcurrentHashTable<Key, Val, Stripes>::ConcurrentHashTable(const size_t cap) {
+        size_t pow2 = 16;
+        while (pow2 < cap) pow2 *= 2;
+        table_.store(new Table(pow2));
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    ConcurrentHashTable<Key, Val, Stripes>::~ConcurrentHashTable() {
+        Table *table = table_.load();
+        for (size_t i = 0; i < table->cap; ++i) {
+            Node *node = table->slots[i].load(std::memory_order_relaxed);
+            if (node != nullptr && node != tombstone()) delete node;
+        }
+        delete table;
+
+        for (auto *node: retired_nodes_) delete node;
+        for (auto *old: retired_tables_) delete old;
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    size_t ConcurrentHashTable<Key, Val, Stripes>::hash_of(const Key &key) {
+        std::uint64_t h = std::hash<Key>{}(key);
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(h ^ (h >> 31));
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    size_t ConcurrentHashTable<Key, Val, Stripes>::reader_slot() {
+        thread_local const size_t slot = std::hash<std::thread::id>{}(std::this_thread::get_id()) % kReaderSlots;
+        return slot;
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    std::mutex &ConcurrentHashTable<Key, Val, Stripes>::stripe(const size_t hash) const {
+        return stripes_[(hash >> 7) % Stripes].mutex;
+    }
+
+    // grow_if_needed расширяет таблицу, когда занято больше 2/3 ячеек (с учетом меток
+    // "удалено"). Все полосы блокируются, поэтому писатели ждут, а читатели - нет
+    template<typename Key, typename Val, size_t Stripes>
+    void ConcurrentHashTable<Key, Val, Stripes>::grow_if_needed() {
+        if ((used_.load() + 1) * 3 <= table_.load()->cap * 2) return;
+
+        for (auto &s: stripes_) s.mutex.lock();
+
+        Table *old = table_.load();
+        if ((used_.load() + 1) * 3 > old->cap * 2) {
+            const size_t live = size_.load();
+            size_t cap = 16;
+            while (cap < (live + 1) * 3) cap *= 2;
+
+            auto *fresh = new Table(cap);
+            for (size_t i = 0; i < old->cap; ++i) {
+                Node *node = old->slots[i].load(std::memory_order_relaxed);
+                if (node == nullptr || node == tombstone()) continue;
+
+                size_t j = node->hash & (cap - 1);
+                while (fresh->slots[j].load(std::memory_order_relaxed) != nullptr) {
+                    j = (j + 1) & (cap - 1);
+                }
+                fresh->slots[j].store(node, std::memory_order_relaxed);
+            }
+
+            table_.store(fresh, std::memory_order_release);
+            used_.store(live);
+            retire(old);
+        }
+
+        for (auto &s: stripes_) s.mutex.unlock();
+
+        reclaim();
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    void ConcurrentHashTable<Key, Val, Stripes>::retire(Node *node) {
+        bool should_reclaim;
+        {
+            std::lock_guard lock(retire_mutex_);
+            retired_nodes_.push_back(node);
+            should_reclaim = retired_nodes_.size() >= kReclaimThreshold;
+        }
+        if (should_reclaim) reclaim();
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    void ConcurrentHashTable<Key, Val, Stripes>::retire(Table *table) {
+        std::lock_guard lock(retire_mutex_);
+        retired_tables_.push_back(table);
+    }
+
+    // reclaim освобождает вытесненные узлы и таблицы: меняет эпоху и ждет, пока
+    // завершатся читатели прошлой эпохи. Новые читатели вытесненное уже не увидят
+    template<typename Key, typename Val, size_t Stripes>
+    void ConcurrentHashTable<Key, Val, Stripes>::reclaim() {
+        std::lock_guard reclaim_lock(reclaim_mutex_);
+
+        Vector<Node *> nodes;
+        Vector<Table *> tables;
+        {
+            std::lock_guard lock(retire_mutex_);
+            nodes = std::move(retired_nodes_);
+            tables = std::move(retired_tables_);
+            retired_nodes_ = Vector<Node *>();
+            retired_tables_ = Vector<Table *>();
+        }
+
+        if (nodes.empty() && tables.empty()) return;
+
+        const unsigned previous = epoch_.fetch_add(1);
+        for (auto &slot: readers_) {
+            while (slot.active[previous & 1].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        for (auto *node: nodes) delete node;
+        for (auto *table: tables) delete table;
+    }
+
+    // insert резервирует ячейку в used_ под блокировкой полосы до того, как ее занять: иначе
+    // писатели разных полос, одновременно прошедшие grow_if_needed, вместе заполнили бы таблицу
+    // сверх 2/3. Если резерва нет, таблица расширяется, и вставка повторяется
+    template<typename Key, typename Val, size_t Stripes>
+    bool ConcurrentHashTable<Key, Val, Stripes>::insert(const Key &key, const Val &val) {
+        const size_t h = hash_of(key);
+
+        for (;;) {
+            grow_if_needed();
+
+            std::lock_guard lock(stripe(h));
+            Table *table = table_.load(std::memory_order_acquire);
+            if ((used_.fetch_add(1) + 1) * 3 > table->cap * 2) {
+                used_.fetch_sub(1);
+                continue;
+            }
+
+            const size_t mask = table->cap - 1;
+            size_t i = h & mask;
+            for (size_t attempt = 0; attempt < table->cap; ++attempt, i = (i + 1) & mask) {
+                Node *node = table->slots[i].load(std::memory_order_acquire);
+
+                if (node == nullptr) {
+                    auto *fresh = new Node{key, val, h};
+                    if (table->slots[i].compare_exchange_strong(node, fresh, std::memory_order_acq_rel)) {
+                        size_.fetch_add(1);
+                        return true;
+                    }
+                    // ячейку занял писатель другой полосы, его ключ заведомо другой
+                    delete fresh;
+                    continue;
+                }
+
+                if (node != tombstone() && node->hash == h && node->key == key) {
+                    used_.fetch_sub(1);
+                    return false;
+                }
+            }
+
+            used_.fetch_sub(1);
+            throw std::overflow_error("Таблица заполнена");
+        }
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    bool ConcurrentHashTable<Key, Val, Stripes>::update(const Key &key, const Val &val) {
+        const size_t h = hash_of(key);
+
+        std::lock_guard lock(stripe(h));
+        Table *table = table_.load(std::memory_order_acquire);
+        const size_t mask = table->cap - 1;
+
+        size_t i = h & mask;
+        for (size_t attempt = 0; attempt < table->cap; ++attempt, i = (i + 1) & mask) {
+            Node *node = table->slots[i].load(std::memory_order_acquire);
+            if (node == nullptr) return false;
+
+            if (node != tombstone() && node->hash == h && node->key == key) {
+                table->slots[i].store(new Node{key, val, h}, std::memory_order_release);
+                retire(node);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    bool ConcurrentHashTable<Key, Val, Stripes>::erase(const Key &key) {
+        const size_t h = hash_of(key);
+
+        std::lock_guard lock(stripe(h));
+        Table *table = table_.load(std::memory_order_acquire);
+        const size_t mask = table->cap - 1;
+
+        size_t i = h & mask;
+        for (size_t attempt = 0; attempt < table->cap; ++attempt, i = (i + 1) & mask) {
+            Node *node = table->slots[i].load(std::memory_order_acquire);
+            if (node == nullptr) return false;
+
+            if (node != tombstone() && node->hash == h && node->key == key) {
+                table->slots[i].store(tombstone(), std::memory_order_release);
+                size_.fetch_sub(1);
+                retire(node);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // find ищет ключ без блокировок и вызывает on_found(const Val&), пока узел защищен
+    // от освобождения
+    template<typename Key, typename Val, size_t Stripes>
+    template<typename Callback>
+    bool ConcurrentHashTable<Key, Val, Stripes>::find(const Key &key, Callback &&on_found) const {
+        ReadGuard guard(*this);
+
+        const size_t h = hash_of(key);
+        const Table *table = table_.load(std::memory_order_acquire);
+        const size_t mask = table->cap - 1;
+
+        size_t i = h & mask;
+        for (size_t attempt = 0; attempt < table->cap; ++attempt, i = (i + 1) & mask) {
+            const Node *node = table->slots[i].load(std::memory_order_acquire);
+            if (node == nullptr) return false;
+
+            if (node != tombstone() && node->hash == h && node->key == key) {
+                on_found(node->val);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    std::optional<Val> ConcurrentHashTable<Key, Val, Stripes>::get(const Key &key) const {
+        std::optional<Val> result;
+        find(key, [&result](const Val &val) { result.emplace(val); });
+        return result;
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    bool ConcurrentHashTable<Key, Val, Stripes>::contains(const Key &key) const {
+        return find(key, [](const Val &) {});
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    size_t ConcurrentHashTable<Key, Val, Stripes>::size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    size_t ConcurrentHashTable<Key, Val, Stripes>::capacity() const {
+        ReadGuard guard(*this);
+        return table_.load(std::memory_order_acquire)->cap;
+    }
+
+    template<typename Key, typename Val, size_t Stripes>
+    bool ConcurrentHashTable<Key, Val, Stripes>::empty() const {
+        return size() == 0;
+    }
+}
+
+#endif //CONCURRENTHASHTABLE_H
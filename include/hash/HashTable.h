@@ -5,14 +5,30 @@
 #ifndef HASHTABLE_H
 #define HASHTABLE_H
 
+#include <algorithm>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <sstream>
 #include "detail/Entry.h"
 #include "detail/EntryStatus.h"
 #include "detail/Iterator.h"
+#include "detail/Prefetch.h"
 #include "../Slog.h"
 
 namespace hash {
+    // ProbeStats - сводка по кластерам линейного пробирования. Кластер - непрерывная
+    // последовательность занятых или удаленных ячеек; distance - расстояние от домашней
+    // ячейки ключа до ячейки, где он лежит (сколько проб нужно для поиска минус один)
+    struct ProbeStats {
+        size_t occupied = 0;
+        size_t deleted = 0;
+        size_t clusters = 0;
+        size_t longest_cluster = 0;
+        size_t max_distance = 0;
+        double average_distance = 0;
+    };
+
     template<typename Key, typename Val>
     class HashTable {
     public:
@@ -24,6 +40,9 @@ namespace hash {
         template<typename Container>
         friend class detail::Iterator;
 
+        // количество ключей, которые search_many разрешает одновременно
+        static constexpr size_t kBatch = 16;
+
         // table capacity
         size_t cap_;
         // count of elements in table
@@ -31,9 +50,17 @@ namespace hash {
 
         EntryType *table_ = nullptr;
 
+        // ресурс, из которого выделяются ячейки и пары ключ-значение
+        std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+
+        void release_table();
+
         // Простая хеш-функция для строк
         size_t primary_hash(const Key &key) const;
 
+        // home_slot - та же хеш-функция без журналирования, для инспектора и search_many
+        size_t home_slot(const Key &key) const;
+
         // Вторичная хеш-функция
         [[nodiscard]] size_t secondary_hash(size_t primary, size_t attempt) const;
 
@@ -47,8 +74,12 @@ namespace hash {
         template<typename Callback>
         size_t find(const Key &key, const Val &val, Callback &&visit) const;
 
+        static const Key &key_ref(const Key &key) { return key; }
+        static const Key &key_ref(const Key *key) { return *key; }
+
     public:
-        explicit HashTable(size_t cap = 16);
+        explicit HashTable(size_t cap = 16,
+                           std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         ~HashTable();
 
@@ -67,6 +98,9 @@ namespace hash {
         template<typename Callback>
         const EntryType *search(const Key &key, const Val &val, Callback &&visit) const;
 
+        template<typename KeyRef, typename Callback>
+        void search_many(std::span<const KeyRef> keys, std::span<const EntryType *> out, Callback &&visit) const;
+
         HashTable(const HashTable &) = delete;
 
         HashTable &operator=(const HashTable &) = delete;
@@ -90,21 +124,32 @@ namespace hash {
         [[nodiscard]] bool empty() const;
 
         [[nodiscard]] std::string structure(bool show_only_occupied = true) const;
+
+        [[nodiscard]] detail::EntryStatus slot_status(size_t index) const;
+        [[nodiscard]] size_t probe_distance(size_t index) const;
+        [[nodiscard]] ProbeStats probe_stats() const;
     };
 
     template<typename Key, typename Val>
     size_t HashTable<Key, Val>::primary_hash(const Key &key) const {
+        const size_t hash = home_slot(key);
+
+        if constexpr (std::is_same_v<Key, std::string>) {
+            Slog::info("Первичная хеш функция", Slog::opt("хеш", hash));
+        }
+
+        return hash;
+    }
+
+    template<typename Key, typename Val>
+    size_t HashTable<Key, Val>::home_slot(const Key &key) const {
         if constexpr (std::is_same_v<Key, std::string>) {
             size_t sum = 0;
             for (const char c: key) {
                 sum += static_cast<size_t>(c);
             }
 
-            size_t hash = sum % cap_;
-
-            Slog::info("Первичная хеш функция", Slog::opt("хеш", hash));
-
-            return hash;
+            return sum % cap_;
         }
 
         return std::hash<Key>{}(key) % cap_;
@@ -167,13 +212,29 @@ namespace hash {
     }
 
     template<typename Key, typename Val>
-    HashTable<Key, Val>::HashTable(const size_t cap) : cap_(cap > 3 ? cap : 16), size_(0) {
-        table_ = new EntryType[cap_];
+    HashTable<Key, Val>::HashTable(const size_t cap, std::pmr::memory_resource *resource)
+        : cap_(cap > 3 ? cap : 16), size_(0), resource_(resource) {
+        std::pmr::polymorphic_allocator<EntryType> alloc(resource_);
+        table_ = alloc.allocate(cap_);
+        std::uninitialized_default_construct_n(table_, cap_);
+    }
+
+    // release_table освобождает пары всех ячеек и саму таблицу
+    template<typename Key, typename Val>
+    void HashTable<Key, Val>::release_table() {
+        if (table_ == nullptr) return;
+
+        for (size_t i = 0; i < cap_; ++i) {
+            table_[i].release(resource_);
+        }
+        std::destroy_n(table_, cap_);
+        std::pmr::polymorphic_allocator<EntryType>(resource_).deallocate(table_, cap_);
+        table_ = nullptr;
     }
 
     template<typename Key, typename Val>
     HashTable<Key, Val>::~HashTable() {
-        delete[] table_;
+        release_table();
     }
 
     template<typename Key, typename Val>
@@ -183,7 +244,7 @@ namespace hash {
         }
 
         size_t index = prepare_append(key);
-        table_[index].insert(key, val);
+        table_[index].insert(key, val, resource_);
         ++size_;
         Slog::info("Элемент добавлен",
                    Slog::opt("индекс", index),
@@ -310,13 +371,101 @@ namespace hash {
         return &table_[index];
     }
 
+    // search_many выполняет пакетный поиск ключей. Ключи обрабатываются пакетами по kBatch:
+    // сначала считаются первичные хеши всех ключей пакета и подгружаются их ячейки, пары и
+    // ключи, затем пробы разрешаются поочередно - каждый ключ делает одну пробу за проход,
+    // а его следующая ячейка подгружается, пока проверяются остальные ключи. Так промахи
+    // кеша у независимых ключей перекрываются, а не ожидаются один за другим. Пробы не
+    // журналируются (home_slot вместо primary_hash) - в журнал пишется одна сводка на вызов.
+    // out[i] получает ячейку для keys[i] или nullptr, если ключ не найден.
+    // keys может содержать как сами ключи, так и указатели на них
+    template<typename Key, typename Val>
+    template<typename KeyRef, typename Callback>
+    void HashTable<Key, Val>::search_many(std::span<const KeyRef> keys, std::span<const EntryType *> out,
+                                          Callback &&visit) const {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("Буфер результатов меньше количества ключей");
+
+        for (size_t base = 0; base < keys.size(); base += kBatch) {
+            const size_t count = std::min(kBatch, keys.size() - base);
+
+            size_t home[kBatch];
+            size_t current[kBatch];
+            size_t attempt[kBatch];
+            bool done[kBatch];
+
+            for (size_t i = 0; i < count; ++i) {
+                out[base + i] = nullptr;
+            }
+
+            if (size_ < 1) continue;
+
+            // считаем хеши и подгружаем домашние ячейки
+            for (size_t i = 0; i < count; ++i) {
+                home[i] = current[i] = home_slot(key_ref(keys[base + i]));
+                attempt[i] = 0;
+                done[i] = false;
+                detail::prefetch(&table_[home[i]]);
+            }
+
+            // ячейки уже загружаются, подгружаем пары занятых ячеек
+            for (size_t i = 0; i < count; ++i) {
+                if (table_[home[i]].status() == detail::OCCUPIED)
+                    detail::prefetch(table_[home[i]].pair());
+            }
+
+            // подгружаем сами ключи
+            for (size_t i = 0; i < count; ++i) {
+                if (table_[home[i]].status() == detail::OCCUPIED)
+                    detail::prefetch(table_[home[i]].key());
+            }
+
+            // разрешаем пробы поочередно
+            size_t pending = count;
+            while (pending > 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (done[i]) continue;
+
+                    visit();
+                    const auto &entry = table_[current[i]];
+
+                    if (entry.status() == detail::EMPTY) {
+                        done[i] = true;
+                        --pending;
+                        continue;
+                    }
+
+                    if (entry.status() == detail::OCCUPIED &&
+                        entry.key() != nullptr &&
+                        *entry.key() == key_ref(keys[base + i])) {
+                        out[base + i] = &entry;
+                        done[i] = true;
+                        --pending;
+                        continue;
+                    }
+
+                    if (++attempt[i] >= cap_) {
+                        done[i] = true;
+                        --pending;
+                        continue;
+                    }
+
+                    current[i] = (home[i] + attempt[i]) % cap_;
+                    detail::prefetch(&table_[current[i]]);
+                }
+            }
+        }
+
+        Slog::info("Пакетный поиск завершен", Slog::opt("ключей", keys.size()));
+    }
+
     template<typename Key, typename Val>
     template<typename Callback>
     void HashTable<Key, Val>::update(const Key &key, const Val &val, Callback &&visit) {
         auto index = this->find(key, std::forward<Callback>(visit));
         if (index == cap_) return;
         auto &entry = table_[index];
-        entry.insert(key, val);
+        entry.insert(key, val, resource_);
         Slog::info("Элемент обновлен",
                    Slog::opt("ключ", key),
                    Slog::opt("значение", val)
@@ -399,14 +548,72 @@ namespace hash {
         return oss.str();
     }
 
+    template<typename Key, typename Val>
+    detail::EntryStatus HashTable<Key, Val>::slot_status(const size_t index) const {
+        return table_[index].status();
+    }
+
+    // probe_distance возвращает, на сколько ячеек ключ в ячейке index сдвинут от своей
+    // домашней ячейки; для пустых и удаленных ячеек - 0
+    template<typename Key, typename Val>
+    size_t HashTable<Key, Val>::probe_distance(const size_t index) const {
+        if (table_[index].status() != detail::OCCUPIED) return 0;
+        const size_t home = home_slot(*table_[index].key());
+        return (index + cap_ - home) % cap_;
+    }
+
+    // probe_stats одним проходом по таблице считает кластеры и расстояния пробирования
+    template<typename Key, typename Val>
+    ProbeStats HashTable<Key, Val>::probe_stats() const {
+        ProbeStats stats;
+        size_t run = 0;
+        size_t total_distance = 0;
+
+        for (size_t i = 0; i < cap_; ++i) {
+            const auto status = table_[i].status();
+            if (status == detail::EMPTY) {
+                if (run > 0) ++stats.clusters;
+                stats.longest_cluster = std::max(stats.longest_cluster, run);
+                run = 0;
+                continue;
+            }
+
+            ++run;
+            if (status == detail::DELETED) {
+                ++stats.deleted;
+                continue;
+            }
+
+            ++stats.occupied;
+            const size_t distance = probe_distance(i);
+            total_distance += distance;
+            stats.max_distance = std::max(stats.max_distance, distance);
+        }
+
+        // кластер в конце таблицы продолжается с ее начала
+        if (run > 0) {
+            size_t head = 0;
+            while (head < cap_ && run + head < cap_ && table_[head].status() != detail::EMPTY) ++head;
+            if (head > 0 && stats.clusters > 0) --stats.clusters;
+            ++stats.clusters;
+            stats.longest_cluster = std::max(stats.longest_cluster, run + head);
+        }
+
+        if (stats.occupied > 0)
+            stats.average_distance = static_cast<double>(total_distance) / stats.occupied;
+
+        return stats;
+    }
+
     template<typename Key, typename Val>
     HashTable<Key, Val> &HashTable<Key, Val>::operator=(HashTable &&other) noexcept {
         if (this != &other) {
-            delete[] table_;
+            release_table();
 
             cap_ = other.cap_;
             size_ = other.size_;
             table_ = other.table_;
+            resource_ = other.resource_;
 
             other.table_ = nullptr;
             other.cap_ = 0;
@@ -417,7 +624,7 @@ namespace hash {
 
     template<typename Key, typename Val>
     HashTable<Key, Val>::HashTable(HashTable &&other) noexcept
-        : cap_(other.cap_), size_(other.size_), table_(other.table_) {
+        : cap_(other.cap_), size_(other.size_), table_(other.table_), resource_(other.resource_) {
         other.table_ = nullptr;
         other.cap_ = 0;
         other.size_ = 0;
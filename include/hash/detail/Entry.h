@@ -4,6 +4,8 @@
 
 #ifndef ENTRY_H
 #define ENTRY_H
+#include <memory_resource>
+
 #include "EntryStatus.h"
 #include "Pair.h"
 
@@ -17,6 +19,8 @@ namespace hash::detail {
     * статусом OCCUPIED.
     * Метод del() меняет статус ячейки на DELETED.
     *
+    * Пара выделяется из переданного ресурса памяти (по умолчанию - глобального);
+    * освобождает ее release() с тем же ресурсом.
     */
     template<typename Key, typename Val>
     class Entry {
@@ -25,17 +29,21 @@ namespace hash::detail {
 
     public:
         Entry();
-        Entry(const Key &key, const Val &val);
+        Entry(const Key &key, const Val &val,
+              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         bool operator==(const Entry &other) const;
         bool operator!=(const Entry &other) const;
 
-        void insert(const Key &key, const Val &val);
+        void insert(const Key &key, const Val &val,
+                    std::pmr::memory_resource *resource = std::pmr::get_default_resource());
         void del();
+        void release(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         [[nodiscard]] EntryStatus status() const;
         [[nodiscard]] Key *key() const;
         [[nodiscard]] Val *val() const;
+        [[nodiscard]] const Pair<Key, Val> *pair() const;
 
         friend std::ostream& operator<<(std::ostream& os, Entry const& e) {
             os << "'" << *e.pair_->key() << "'" << "=" << "'" << *e.pair_->val() << "'";
@@ -50,8 +58,8 @@ namespace hash::detail {
     }
 
     template<typename Key, typename Val>
-    Entry<Key, Val>::Entry(const Key &key, const Val &val) {
-        pair_ = new Pair<Key, Val>(key, val);
+    Entry<Key, Val>::Entry(const Key &key, const Val &val, std::pmr::memory_resource *resource) {
+        pair_ = std::pmr::polymorphic_allocator<>(resource).new_object<Pair<Key, Val>>(key, val);
         status_ = OCCUPIED;
     }
 
@@ -66,12 +74,21 @@ namespace hash::detail {
     }
 
     template<typename Key, typename Val>
-    void Entry<Key, Val>::insert(const Key &key, const Val &val) {
-        delete pair_;
-        pair_ = new Pair<Key, Val>(key, val);
+    void Entry<Key, Val>::insert(const Key &key, const Val &val, std::pmr::memory_resource *resource) {
+        release(resource);
+        pair_ = std::pmr::polymorphic_allocator<>(resource).new_object<Pair<Key, Val>>(key, val);
         status_ = OCCUPIED;
     }
 
+    // release освобождает пару и возвращает ячейку в состояние EMPTY
+    template<typename Key, typename Val>
+    void Entry<Key, Val>::release(std::pmr::memory_resource *resource) {
+        if (pair_ != nullptr)
+            std::pmr::polymorphic_allocator<>(resource).delete_object(pair_);
+        pair_ = nullptr;
+        status_ = EMPTY;
+    }
+
     template<typename Key, typename Val>
     void Entry<Key, Val>::del() {
         status_ = DELETED;
@@ -91,6 +108,11 @@ namespace hash::detail {
     Val *Entry<Key, Val>::val() const {
         return pair_->val();
     }
+
+    template<typename Key, typename Val>
+    const Pair<Key, Val> *Entry<Key, Val>::pair() const {
+        return pair_;
+    }
 }
 
 #endif //ENTRY_H
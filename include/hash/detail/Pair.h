@@ -6,22 +6,21 @@
 #define PAIR_H
 
 namespace hash::detail {
+    // Pair хранит ключ и значение прямо в себе: ячейке таблицы нужно одно выделение памяти
+    // под пару, а не три
     template<typename Key, typename Val>
     class Pair {
-        Key *key_ = nullptr;
-        Val *val_ = nullptr;
+        Key key_;
+        Val val_;
 
     public:
-        Pair(const Key &key, const Val &val) : key_(new Key(key)), val_(new Val(val)) {
+        Pair(const Key &key, const Val &val) : key_(key), val_(val) {
         }
 
-        ~Pair() {
-            delete key_;
-            delete val_;
-        }
-
-        Key *key() const { return key_; }
-        Val *val() const { return val_; }
+        Key *key() { return &key_; }
+        Val *val() { return &val_; }
+        const Key *key() const { return &key_; }
+        const Val *val() const { return &val_; }
     };
 }
 
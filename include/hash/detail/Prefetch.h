@@ -0,0 +1,22 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace hash::detail {
+    // prefetch подсказывает процессору загрузить строку кеша по адресу p заранее,
+    // чтобы последующее обращение к ней не ждало память
+    inline void prefetch(const void *p) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void) p;
+#endif
+    }
+}
+
+#endif //PREFETCH_H
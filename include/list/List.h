@@ -1,44 +1,157 @@
 #ifndef LIST_H
 #define LIST_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <stdexcept>
+#include <sstream>
+#include <utility>
 
-// Данный модуль определяет двусвязный список совместимый с API SLList
+// Данный модуль определяет развернутый список, совместимый с API SLList.
+//
+// Элементы хранятся блоками (Chunk) по kChunkCapacity штук: блок занимает около двух кеш-линий,
+// и на kChunkCapacity элементов приходится одно выделение памяти и один переход по указателю.
+// Порядок элементов сохраняется: удаление сдвигает хвост своего блока, опустевший блок
+// возвращается в ресурс памяти списка. Ресурс по умолчанию - глобальный; справочник оценок
+// передает деревьям общий пул, из которого берутся и узлы деревьев, и блоки их списков.
+// Обход - двунаправленными итераторами за O(1) на шаг; operator[] идет по блокам, а не по элементам
 
 template <typename T>
 class List {
+    struct Chunk {
+        Chunk *next = nullptr;
+        Chunk *prev = nullptr;
+        std::uint32_t count = 0;
+    };
+
 public:
-    class Node {
+    // kChunkCapacity подобран так, чтобы блок занимал около 128 байт
+    static constexpr size_t kChunkCapacity = std::max<size_t>(4, (128 - sizeof(Chunk)) / sizeof(T));
+
+private:
+    // элементы лежат сразу за заголовком блока
+    struct Block : Chunk {
+        alignas(T) std::byte storage[kChunkCapacity * sizeof(T)];
+
+        T *items() noexcept { return reinterpret_cast<T *>(storage); }
+        const T *items() const noexcept { return reinterpret_cast<const T *>(storage); }
+    };
+
+    template<bool Const>
+    class BasicIterator {
+        using BlockPtr = std::conditional_t<Const, const Block *, Block *>;
+        using ListPtr = std::conditional_t<Const, const List *, List *>;
+
+        BlockPtr block_ = nullptr;
+        std::uint32_t index_ = 0;
+        // список нужен, чтобы декремент end() перешел к последнему элементу
+        ListPtr list_ = nullptr;
+
+        friend class List;
+
+        BasicIterator(BlockPtr block, const std::uint32_t index, ListPtr list)
+            : block_(block), index_(index), list_(list) {
+        }
+
     public:
-        explicit Node(T data, Node* pNext = nullptr, Node* pPrev = nullptr) {
-            this->pNext = pNext;
-            this->pPrev = pPrev;
-            this->data = data;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+        using reference = std::conditional_t<Const, const T &, T &>;
+
+        BasicIterator() = default;
+
+        // итератор превращается в константный, но не наоборот
+        template<bool OtherConst> requires (Const && !OtherConst)
+        BasicIterator(const BasicIterator<OtherConst> &other)
+            : block_(other.block_), index_(other.index_), list_(other.list_) {
         }
-        Node* pNext = nullptr;
-        Node* pPrev = nullptr;
-        T data = T();
+
+        reference operator*() const { return block_->items()[index_]; }
+        pointer operator->() const { return block_->items() + index_; }
+
+        BasicIterator &operator++() {
+            if (++index_ == block_->count) {
+                block_ = static_cast<BlockPtr>(block_->next);
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        BasicIterator &operator--() {
+            if (block_ == nullptr) {
+                block_ = static_cast<BlockPtr>(list_->tail_);
+                index_ = block_->count - 1;
+            } else if (index_ == 0) {
+                block_ = static_cast<BlockPtr>(block_->prev);
+                index_ = block_->count - 1;
+            } else {
+                --index_;
+            }
+            return *this;
+        }
+
+        BasicIterator operator--(int) {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        template<bool OtherConst>
+        bool operator==(const BasicIterator<OtherConst> &other) const {
+            return block_ == other.block_ && index_ == other.index_;
+        }
+
+        template<bool> friend class BasicIterator;
     };
 
+public:
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
     List();
+    explicit List(std::pmr::memory_resource *resource);
+    // копия, как и у контейнеров std::pmr, выделяет память из ресурса по умолчанию
+    List(const List &other);
+    List(List &&other) noexcept;
+    List &operator=(const List &other);
+    List &operator=(List &&other);
     ~List();
 
     void del(T data);
     void del_after(T data);
     void add(T data);
     void push_back(T data);
-    Node* search(T data);
-    void print();
+    [[nodiscard]] bool contains(const T &data) const;
+    iterator find(const T &data);
+    const_iterator find(const T &data) const;
+    iterator erase(const_iterator pos);
+    void clear();
+    void print() const;
     std::string structure() const;
-    List* copy();
-    int count(T data);
+    List* copy() const;
+    int count(T data) const;
     [[nodiscard]] int count() const;
-    T get_first();
+    [[nodiscard]] bool empty() const;
+    T get_first() const;
 
-    Node* head = nullptr;
-    Node* tail = nullptr;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
 
     bool operator==(const List<T> &other) const;
     T& operator[](size_t index);
@@ -48,175 +161,239 @@ public:
     const T& at(size_t index) const;
 
 private:
+    Block *head_ = nullptr;
+    Block *tail_ = nullptr;
     size_t size_ = 0;
+    std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+
+    Block *make_block();
+    void unlink(Block *block);
+    void steal(List &other) noexcept;
+    const T *locate(size_t index) const;
 };
 
 template<typename T>
 List<T>::List() = default;
 
+template<typename T>
+List<T>::List(std::pmr::memory_resource *resource) : resource_(resource) {
+}
+
+template<typename T>
+List<T>::List(const List &other) {
+    for (const auto &item: other) {
+        push_back(item);
+    }
+}
+
+template<typename T>
+List<T>::List(List &&other) noexcept : resource_(other.resource_) {
+    steal(other);
+}
+
+template<typename T>
+List<T> &List<T>::operator=(const List &other) {
+    if (this == &other)
+        return *this;
+
+    clear();
+    for (const auto &item: other) {
+        push_back(item);
+    }
+    return *this;
+}
+
+// при перемещении блоки передаются целиком, только если их сможет освободить наш ресурс;
+// иначе элементы копируются в нашу память
+template<typename T>
+List<T> &List<T>::operator=(List &&other) {
+    if (this == &other)
+        return *this;
+
+    clear();
+    if (resource_->is_equal(*other.resource_)) {
+        steal(other);
+    } else {
+        for (auto &item: other) {
+            push_back(std::move(item));
+        }
+        other.clear();
+    }
+    return *this;
+}
+
 template<typename T>
 List<T>::~List() {
-    while (head != nullptr) {
-        Node* next = head->pNext;
-        delete head;
-        head = next;
+    clear();
+}
+
+template<typename T>
+typename List<T>::Block *List<T>::make_block() {
+    return std::pmr::polymorphic_allocator<>(resource_).new_object<Block>();
+}
+
+// unlink убирает пустой блок из цепочки и возвращает его в ресурс памяти
+template<typename T>
+void List<T>::unlink(Block *block) {
+    if (block->prev) block->prev->next = block->next;
+    else head_ = static_cast<Block *>(block->next);
+
+    if (block->next) block->next->prev = block->prev;
+    else tail_ = static_cast<Block *>(block->prev);
+
+    std::pmr::polymorphic_allocator<>(resource_).delete_object(block);
+}
+
+template<typename T>
+void List<T>::steal(List &other) noexcept {
+    head_ = std::exchange(other.head_, nullptr);
+    tail_ = std::exchange(other.tail_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+}
+
+template<typename T>
+void List<T>::clear() {
+    while (head_ != nullptr) {
+        Block *next = static_cast<Block *>(head_->next);
+        std::destroy_n(head_->items(), head_->count);
+        std::pmr::polymorphic_allocator<>(resource_).delete_object(head_);
+        head_ = next;
     }
+    tail_ = nullptr;
+    size_ = 0;
 }
 
+// del удаляет все вхождения data; оставшиеся элементы каждого блока уплотняются за один проход
 template<typename T>
 void List<T>::del(T data) {
-    Node* current = head;
-    
-    while (current != nullptr) {
-        if (current->data == data) {
-            // Обновляем указатели
-            if (current->pPrev) {
-                current->pPrev->pNext = current->pNext;
-            } else {
-                head = current->pNext;
-            }
-            
-            if (current->pNext) {
-                current->pNext->pPrev = current->pPrev;
-            } else {
-                tail = current->pPrev;
-            }
-            
-            Node* next = current->pNext;
-            delete current;
-            current = next;
-            size_--;
-        } else {
-            current = current->pNext;
+    Block *block = head_;
+
+    while (block != nullptr) {
+        Block *next = static_cast<Block *>(block->next);
+        T *items = block->items();
+
+        std::uint32_t kept = 0;
+        for (std::uint32_t i = 0; i < block->count; ++i) {
+            if (items[i] == data) continue;
+            if (kept != i) items[kept] = std::move(items[i]);
+            ++kept;
         }
+
+        std::destroy(items + kept, items + block->count);
+        size_ -= block->count - kept;
+        block->count = kept;
+        if (kept == 0) unlink(block);
+
+        block = next;
     }
 }
 
+// del_after удаляет элемент, следующий за первым вхождением data
 template<typename T>
 void List<T>::del_after(T data) {
-    Node* current = search(data);
-    if (current != nullptr && current->pNext != nullptr) {
-        Node* toDelete = current->pNext;
-        
-        current->pNext = toDelete->pNext;
-        if (toDelete->pNext) {
-            toDelete->pNext->pPrev = current;
-        } else {
-            tail = current;
-        }
-        
-        delete toDelete;
-        size_--;
+    auto pos = find(data);
+    if (pos == end()) return;
+
+    if (++pos != end()) erase(pos);
+}
+
+// erase удаляет элемент в позиции pos и возвращает итератор на следующий за ним
+template<typename T>
+typename List<T>::iterator List<T>::erase(const_iterator pos) {
+    Block *block = const_cast<Block *>(pos.block_);
+    T *items = block->items();
+
+    std::move(items + pos.index_ + 1, items + block->count, items + pos.index_);
+    std::destroy_at(items + block->count - 1);
+    --block->count;
+    --size_;
+
+    if (block->count == 0) {
+        Block *next = static_cast<Block *>(block->next);
+        unlink(block);
+        return iterator(next, 0, this);
     }
+    if (pos.index_ == block->count) {
+        return iterator(static_cast<Block *>(block->next), 0, this);
+    }
+    return iterator(block, pos.index_, this);
 }
 
+// add добавляет элемент в конец списка, как и push_back
 template<typename T>
 void List<T>::add(T data) {
-    Node* new_node = new Node(data);
-    
-    if (head == nullptr) {
-        head = tail = new_node;
-    } else {
-        tail->pNext = new_node;
-        new_node->pPrev = tail;
-        new_node->pNext = head;
-        tail = new_node;
-    }
-    size_++;
+    push_back(std::move(data));
 }
 
 template<typename T>
 void List<T>::push_back(T data) {
-    Node* new_node = new Node(data);
-    
-    if (head == nullptr) {
-        head = tail = new_node;
-    } else {
-        tail->pNext = new_node;
-        new_node->pPrev = tail;
-        tail = new_node;
+    if (tail_ == nullptr || tail_->count == kChunkCapacity) {
+        Block *block = make_block();
+        block->prev = tail_;
+        if (tail_) tail_->next = block;
+        else head_ = block;
+        tail_ = block;
     }
-    size_++;
+
+    std::construct_at(tail_->items() + tail_->count, std::move(data));
+    ++tail_->count;
+    ++size_;
 }
 
 template<typename T>
-typename List<T>::Node* List<T>::search(T data) {
-    Node* current = head;
-    
-    while (current != nullptr) {
-        if (current->data == data) {
-            return current;
-        }
-        current = current->pNext;
-    }
-    
-    return nullptr;
+bool List<T>::contains(const T &data) const {
+    return find(data) != end();
 }
 
 template<typename T>
-void List<T>::print() {
-    if (head == nullptr) {
-        std::cout << "[ ]" << '\n';
-        return;
+typename List<T>::iterator List<T>::find(const T &data) {
+    for (auto it = begin(); it != end(); ++it) {
+        if (*it == data) return it;
     }
-    
-    Node* current = head;
-    std::cout << "[";
-    
-    while (current != nullptr) {
-        std::cout << " " << current->data;
-        current = current->pNext;
+    return end();
+}
+
+template<typename T>
+typename List<T>::const_iterator List<T>::find(const T &data) const {
+    for (auto it = begin(); it != end(); ++it) {
+        if (*it == data) return it;
     }
-    
-    std::cout << " ]" << '\n';
+    return end();
+}
+
+template<typename T>
+void List<T>::print() const {
+    std::cout << structure();
 }
 
 template<typename T>
 std::string List<T>::structure() const {
     std::ostringstream oss;
-    if (head == nullptr) {
+    if (size_ == 0) {
         oss << "[ ]" << '\n';
         return oss.str();
     }
-    
-    Node* current = head;
+
     oss << "[";
-    
-    while (current != nullptr) {
-        oss << " " << current->data;
-        current = current->pNext;
+    for (const auto &item: *this) {
+        oss << " " << item;
     }
-    
     oss << " ]" << '\n';
     return oss.str();
 }
 
 template<typename T>
-List<T>* List<T>::copy() {
-    List<T>* new_list = new List<T>();
-    
-    Node* current = head;
-    while (current != nullptr) {
-        new_list->push_back(current->data);
-        current = current->pNext;
+List<T>* List<T>::copy() const {
+    auto *new_list = new List<T>(resource_);
+    for (const auto &item: *this) {
+        new_list->push_back(item);
     }
-    
     return new_list;
 }
 
 template<typename T>
-int List<T>::count(T data) {
-    int counter = 0;
-    Node* current = head;
-    
-    while (current != nullptr) {
-        if (current->data == data) {
-            counter++;
-        }
-        current = current->pNext;
-    }
-    
-    return counter;
+int List<T>::count(T data) const {
+    return static_cast<int>(std::count(begin(), end(), data));
 }
 
 template<typename T>
@@ -225,69 +402,71 @@ int List<T>::count() const {
 }
 
 template<typename T>
-T List<T>::get_first() {
-    if (head == nullptr) {
+bool List<T>::empty() const {
+    return size_ == 0;
+}
+
+template<typename T>
+T List<T>::get_first() const {
+    if (head_ == nullptr) {
         throw std::runtime_error("List is empty");
     }
-    return head->data;
+    return head_->items()[0];
+}
+
+template<typename T>
+typename List<T>::iterator List<T>::begin() {
+    return iterator(head_, 0, this);
+}
+
+template<typename T>
+typename List<T>::iterator List<T>::end() {
+    return iterator(nullptr, 0, this);
+}
+
+template<typename T>
+typename List<T>::const_iterator List<T>::begin() const {
+    return const_iterator(head_, 0, this);
+}
+
+template<typename T>
+typename List<T>::const_iterator List<T>::end() const {
+    return const_iterator(nullptr, 0, this);
 }
 
 template<typename T>
 bool List<T>::operator==(const List<T> &other) const {
-    if (count() != other.count()) return false;
-    
-    Node* currentThis = head;
-    Node* currentOther = other.head;
-    
-    while (currentThis != nullptr && currentOther != nullptr) {
-        if (currentThis->data != currentOther->data) {
-            return false;
-        }
-        currentThis = currentThis->pNext;
-        currentOther = currentOther->pNext;
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+// locate находит элемент по индексу, пропуская блоки целиком
+template<typename T>
+const T *List<T>::locate(size_t index) const {
+    for (const Block *block = head_; block != nullptr; block = static_cast<const Block *>(block->next)) {
+        if (index < block->count) return block->items() + index;
+        index -= block->count;
     }
-    
-    return currentThis == nullptr && currentOther == nullptr;
+    throw std::out_of_range("List index out of range");
 }
 
 template<typename T>
 T& List<T>::operator[](size_t index) {
-    Node* current = head;
-    for (size_t i = 0; i < index && current != nullptr; i++) {
-        current = current->pNext;
-    }
-    
-    if (current == nullptr) {
-        throw std::out_of_range("List index out of range");
-    }
-    
-    return current->data;
+    return *const_cast<T *>(locate(index));
 }
 
 template<typename T>
 const T& List<T>::operator[](size_t index) const {
-    const Node* current = head;
-    for (size_t i = 0; i < index && current != nullptr; i++) {
-        current = current->pNext;
-    }
-    
-    if (current == nullptr) {
-        throw std::out_of_range("List index out of range");
-    }
-    
-    return current->data;
+    return *locate(index);
 }
 
 template<typename T>
 T& List<T>::at(size_t index) {
-    if (head == nullptr) throw std::out_of_range("List::at");
     if (index >= size_) throw std::out_of_range("List::at");
     return (*this)[index];
 }
 
 template<typename T>
 const T& List<T>::at(size_t index) const {
-    if (head == nullptr) throw std::out_of_range("List::at");
     if (index >= size_) throw std::out_of_range("List::at");
     return (*this)[index];
 }
@@ -296,4 +475,4 @@ const T& List<T>::at(size_t index) const {
 template <typename T>
 using SLList = List<T>;
 
-#endif //LIST_H
\ No newline at end of file
+#endif //LIST_H
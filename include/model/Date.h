@@ -5,8 +5,10 @@
 #ifndef DATE_H
 #define DATE_H
 #include <cstdint>
-#include <iomanip>
+#include <ostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 namespace model {
     enum class Month : std::uint8_t {
@@ -22,113 +24,178 @@ namespace model {
         return names[static_cast<int>(m)];
     }
 
-    inline Month str_to_month(const std::string& s) {
-        static const std::pair<const char*, Month> map[] = {
-            {"jan", Month::Jan}, {"feb", Month::Feb}, {"mar", Month::Mar},
-            {"apr", Month::Apr}, {"may", Month::May}, {"jun", Month::Jun},
-            {"jul", Month::Jul}, {"aug", Month::Aug}, {"sep", Month::Sep},
-            {"oct", Month::Oct}, {"nov", Month::Nov}, {"dec", Month::Dec},
-        };
-        for (auto [txt, val] : map)
-            if (s == txt) return val;
-        throw std::invalid_argument("Некорректный месяц");
+    // str_to_month распознает трехбуквенное название месяца без учета регистра. Три буквы
+    // складываются в одно число, и месяц выбирается одним switch вместо прохода по таблице
+    constexpr Month str_to_month(const std::string_view s) {
+        if (s.size() != 3)
+            throw std::invalid_argument("Некорректный месяц");
+
+        auto lower = [](const char c) { return static_cast<std::uint32_t>(c >= 'A' && c <= 'Z' ? c + 32 : c); };
+        switch (lower(s[0]) << 16 | lower(s[1]) << 8 | lower(s[2])) {
+            case 'j' << 16 | 'a' << 8 | 'n': return Month::Jan;
+            case 'f' << 16 | 'e' << 8 | 'b': return Month::Feb;
+            case 'm' << 16 | 'a' << 8 | 'r': return Month::Mar;
+            case 'a' << 16 | 'p' << 8 | 'r': return Month::Apr;
+            case 'm' << 16 | 'a' << 8 | 'y': return Month::May;
+            case 'j' << 16 | 'u' << 8 | 'n': return Month::Jun;
+            case 'j' << 16 | 'u' << 8 | 'l': return Month::Jul;
+            case 'a' << 16 | 'u' << 8 | 'g': return Month::Aug;
+            case 's' << 16 | 'e' << 8 | 'p': return Month::Sep;
+            case 'o' << 16 | 'c' << 8 | 't': return Month::Oct;
+            case 'n' << 16 | 'o' << 8 | 'v': return Month::Nov;
+            case 'd' << 16 | 'e' << 8 | 'c': return Month::Dec;
+            default: throw std::invalid_argument("Некорректный месяц");
+        }
     }
 
+    // Date хранит дату одним 32-битным числом: год << 9 | месяц << 5 | день. Порядок чисел
+    // совпадает с порядком дат, поэтому любое сравнение - одно сравнение целых без ветвлений.
+    // Дата с годом 0 означает "дата не задана"; по умолчанию это 00 jan 0, как и раньше
     class Date {
-        std::uint8_t  day_{0}; // 1-31
-        Month         month_{Month::Jan};
-        std::uint16_t year_{0};
+        std::uint32_t packed_{static_cast<std::uint32_t>(Month::Jan) << 5};
 
-    public:
-        Date() = default;
-        Date(const std::uint8_t d, const Month m, const std::uint16_t y) : day_(d), month_(m), year_(y) {}
+        static constexpr std::uint32_t kMaxYear = 2025;
+        // максимальная длина текстовой записи "dd mon yyyy": year() - 16-битное число,
+        // поэтому под год отводится до пяти цифр
+        static constexpr size_t kTextSize = 12;
 
-        bool operator<(const Date& o) const;
-        bool operator>(const Date& o) const;
-        bool operator==(const Date& o) const;
-        bool operator!() const;
-        bool operator!=(const Date& o) const;
-        bool operator<=(const Date& o) const;
-        bool operator>=(const Date& o) const;
+    public:
+        constexpr Date() = default;
+        constexpr Date(const std::uint8_t d, const Month m, const std::uint16_t y)
+            : packed_(static_cast<std::uint32_t>(y) << 9 | static_cast<std::uint32_t>(m) << 5 | d) {}
+
+        constexpr bool operator<(const Date& o) const { return packed_ < o.packed_; }
+        constexpr bool operator>(const Date& o) const { return packed_ > o.packed_; }
+        constexpr bool operator==(const Date& o) const { return packed_ == o.packed_; }
+        constexpr bool operator!() const { return packed_ >> 9 == 0; }
+        constexpr bool operator!=(const Date& o) const { return packed_ != o.packed_; }
+        constexpr bool operator<=(const Date& o) const { return packed_ <= o.packed_; }
+        constexpr bool operator>=(const Date& o) const { return packed_ >= o.packed_; }
 
         [[nodiscard]] std::string to_string() const;
+        size_t write(char *out) const;
         friend std::ostream& operator<<(std::ostream& os, const Date& d);
 
-        static Date parse(const std::string& str);
+        static constexpr Date parse(std::string_view str);
 
-        [[nodiscard]] std::uint16_t year() const;
-    };
+        [[nodiscard]] constexpr std::uint8_t day() const { return packed_ & 0x1F; }
+        [[nodiscard]] constexpr Month month() const { return static_cast<Month>(packed_ >> 5 & 0x0F); }
+        [[nodiscard]] constexpr std::uint16_t year() const { return static_cast<std::uint16_t>(packed_ >> 9); }
 
-    inline std::ostream & operator<<(std::ostream &os, const Date &d) {
-        return os << d.to_string();
-    }
+        // pack возвращает упакованное значение; порядок чисел совпадает с порядком дат
+        [[nodiscard]] constexpr std::uint32_t pack() const { return packed_; }
+        static constexpr Date unpack(std::uint32_t packed);
 
-    inline bool Date::operator<(const Date &o) const {
-        if (year_  != o.year_)   return year_  < o.year_;
-        if (month_ != o.month_)  return month_ < o.month_;
-        return day_ < o.day_;
-    }
-
-    inline bool Date::operator>(const Date &o) const {
-        return o < *this;
-    }
-
-    inline bool Date::operator==(const Date &o) const {
-        return day_ == o.day_ && month_ == o.month_ && year_ == o.year_;
-    }
+        // to_days и from_days переводят дату в номер дня от 01.01.1970 и обратно
+        // для арифметики над периодами (алгоритм days_from_civil Говарда Хиннанта)
+        [[nodiscard]] constexpr std::int32_t to_days() const;
+        static constexpr Date from_days(std::int32_t days);
+    };
 
-    inline bool Date::operator!() const {
-        return year_ == 0;
+    constexpr Date Date::unpack(const std::uint32_t packed) {
+        Date date;
+        date.packed_ = packed;
+        return date;
     }
 
-    inline bool Date::operator!=(const Date &o) const {
-        return !(*this == o);
+    constexpr std::int32_t Date::to_days() const {
+        const auto m = static_cast<std::int32_t>(month());
+        const std::int32_t y = year() - (m <= 2);
+        const std::int32_t era = (y >= 0 ? y : y - 399) / 400;
+        const std::int32_t yoe = y - era * 400;
+        const std::int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + day() - 1;
+        const std::int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
     }
 
-    inline bool Date::operator<=(const Date &o) const {
-        return !(*this > o);
+    constexpr Date Date::from_days(std::int32_t days) {
+        days += 719468;
+        const std::int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const std::int32_t doe = days - era * 146097;
+        const std::int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const std::int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const std::int32_t mp = (5 * doy + 2) / 153;
+        const std::int32_t d = doy - (153 * mp + 2) / 5 + 1;
+        const std::int32_t m = mp < 10 ? mp + 3 : mp - 9;
+        const std::int32_t y = yoe + era * 400 + (m <= 2);
+        return Date{static_cast<std::uint8_t>(d), static_cast<Month>(m), static_cast<std::uint16_t>(y)};
     }
 
-    inline bool Date::operator>=(const Date &o) const {
-        return !(*this < o);
+    // write пишет дату в формате "dd mon yyyy" в буфер размером не меньше kTextSize
+    // и возвращает количество записанных символов
+    inline size_t Date::write(char *out) const {
+        const auto d = day();
+        const char *mon = month_to_str(month());
+
+        size_t n = 0;
+        out[n++] = static_cast<char>('0' + d / 10);
+        out[n++] = static_cast<char>('0' + d % 10);
+        out[n++] = ' ';
+        out[n++] = mon[0];
+        out[n++] = mon[1];
+        out[n++] = mon[2];
+        out[n++] = ' ';
+
+        char digits[5];
+        size_t len = 0;
+        std::uint32_t y = year();
+        do {
+            digits[len++] = static_cast<char>('0' + y % 10);
+            y /= 10;
+        } while (y != 0);
+        while (len > 0) out[n++] = digits[--len];
+
+        return n;
     }
 
     inline std::string Date::to_string() const {
-        std::ostringstream os;
-        os << std::setfill('0') << std::setw(2) << static_cast<int>(day_) << ' '
-           << month_to_str(month_) << ' '
-           << year_;
-        return os.str();
+        char buf[kTextSize];
+        return {buf, write(buf)};
     }
 
-    inline Date Date::parse(const std::string &str) {
-        std::istringstream iss(str);
-        std::string day_s, mon_s;
-        std::uint16_t year;
+    inline std::ostream & operator<<(std::ostream &os, const Date &d) {
+        char buf[Date::kTextSize];
+        return os.write(buf, static_cast<std::streamsize>(d.write(buf)));
+    }
 
-        if (!(iss >> day_s >> mon_s >> year))
-            throw std::invalid_argument("Неверный формат даты");
+    // parse разбирает "dd mon yyyy" прямо по string_view без потоков и выделений памяти.
+    // Правила прежние: допускаются пробелы вокруг полей, день проверяется только на 1-31
+    // (файлы справочников могут содержать даты вроде 30 feb, и они должны загружаться)
+    constexpr Date Date::parse(const std::string_view str) {
+        size_t i = 0;
+        auto skip_spaces = [&] {
+            while (i < str.size() && (str[i] == ' ' || str[i] == '\t' || str[i] == '\r' || str[i] == '\n')) ++i;
+        };
+        auto is_digit = [](const char c) { return c >= '0' && c <= '9'; };
 
-        if (day_s.size() > 2 || day_s.empty() ||
-            day_s.size() == 1 && !std::isdigit(day_s[0]) ||
-            day_s.size() == 2 && !std::isdigit(day_s[0]) && !std::isdigit(day_s[1]))
+        skip_spaces();
+        const size_t day_start = i;
+        std::uint32_t day = 0;
+        while (i < str.size() && is_digit(str[i])) day = day * 10 + (str[i++] - '0');
+        if (i == day_start && i < str.size())
             throw std::invalid_argument("Некорректный день");
-
-        const auto day = static_cast<std::uint8_t>(std::stoi(day_s));
-        if (day == 0 || day > 31)
+        if (i == day_start)
+            throw std::invalid_argument("Неверный формат даты");
+        if (i - day_start > 2 || day == 0 || day > 31)
             throw std::invalid_argument("Некорректный день");
 
-        for (auto& c : mon_s) c = static_cast<char>(std::tolower(c));
-        const Month month = str_to_month(mon_s);
+        skip_spaces();
+        const size_t month_start = i;
+        while (i < str.size() && str[i] != ' ' && str[i] != '\t') ++i;
+        if (i == month_start)
+            throw std::invalid_argument("Неверный формат даты");
+        const Month month = str_to_month(str.substr(month_start, i - month_start));
 
-        if (year < 0 || year > 2025)
+        skip_spaces();
+        const size_t year_start = i;
+        std::uint32_t year = 0;
+        while (i < str.size() && is_digit(str[i]) && year <= kMaxYear) year = year * 10 + (str[i++] - '0');
+        if (i == year_start)
+            throw std::invalid_argument("Неверный формат даты");
+        if (year > kMaxYear)
             throw std::invalid_argument("Некорректный год");
 
-        return Date{day, month, year};
-    }
-
-    inline std::uint16_t Date::year() const {
-        return year_;
+        return Date{static_cast<std::uint8_t>(day), month, static_cast<std::uint16_t>(year)};
     }
 }
 
@@ -22,6 +22,7 @@ namespace model {
     public:
         Grade(PersonName student_name, Date student_birth_date, std::string subject, int grade, Date date);
         Grade(const Grade& other);
+        Grade(Grade&& other) noexcept;
         Grade();
 
         bool operator<(const Grade &other) const;
@@ -30,10 +31,11 @@ namespace model {
         bool operator!() const;
 
         Grade& operator=(const Grade& other);
+        Grade& operator=(Grade&& other) noexcept;
 
-        [[nodiscard]] model::PersonName get_student_name() const;
+        [[nodiscard]] const model::PersonName &get_student_name() const;
         [[nodiscard]] Date get_student_birth_date() const;
-        [[nodiscard]] std::string get_subject() const;
+        [[nodiscard]] const std::string &get_subject() const;
         [[nodiscard]] int get_grade() const;
         [[nodiscard]] Date get_date() const;
 
@@ -71,22 +73,15 @@ namespace model {
         return !student_name_ && !student_birth_date_ && subject_.empty() && grade_ == 0 && !date_;
     }
 
-    inline Grade & Grade::operator=(const Grade &other) {
-        if (this != &other) {
-            student_name_ = other.student_name_;
-            student_birth_date_ = other.student_birth_date_;
-            subject_ = other.subject_;
-            grade_ = other.grade_;
-            date_ = other.date_;
-        }
-        return *this;
-    }
+    inline Grade & Grade::operator=(const Grade &other) = default;
 
-    inline model::PersonName Grade::get_student_name() const {
+    inline Grade & Grade::operator=(Grade &&other) noexcept = default;
+
+    inline const model::PersonName &Grade::get_student_name() const {
         return student_name_;
     }
 
-    inline std::string Grade::get_subject() const {
+    inline const std::string &Grade::get_subject() const {
         return subject_;
     }
 
@@ -136,7 +131,7 @@ namespace model {
         return Grade{
             model::PersonName::parse(name),
             Date::parse(birth_date_str),
-            subject,
+            std::move(subject),
             grade_value,
             Date::parse(date_str)
         };
@@ -168,6 +163,8 @@ namespace model {
 
     inline Grade::Grade(const Grade &other) = default;
 
+    inline Grade::Grade(Grade &&other) noexcept = default;
+
     inline Grade::Grade() = default;
 }
 
@@ -0,0 +1,36 @@
+#ifndef GRADERECORD_H
+#define GRADERECORD_H
+
+#include <cstdint>
+#include <limits>
+
+#include "Date.h"
+
+namespace model {
+    // StudentHandle - постоянный номер студента в справочнике студентов. В отличие от индекса
+    // в массиве он не меняется, когда другие записи удаляются и массив уплотняется
+    using StudentHandle = std::uint32_t;
+    inline constexpr StudentHandle kNoStudent = std::numeric_limits<StudentHandle>::max();
+
+    // SubjectId - номер предмета в словаре предметов справочника оценок
+    using SubjectId = std::uint16_t;
+    inline constexpr SubjectId kNoSubject = std::numeric_limits<SubjectId>::max();
+
+    // GradeRecord - оценка в том виде, в котором ее хранит справочник оценок: вместо копии
+    // ФИО студента хранится его номер, вместо названия предмета - номер в словаре.
+    // Дата рождения (4 байта) остается в записи, чтобы фильтр проверял ее без обращения
+    // к справочнику студентов; она входит в ключ студента и не меняется.
+    // Grade остается форматом файла и UI, GradeRecord превращается в Grade соединением
+    // со справочником студентов и словарем предметов
+    struct GradeRecord {
+        Date date;
+        Date student_birth_date;
+        StudentHandle student = kNoStudent;
+        SubjectId subject = kNoSubject;
+        std::int8_t grade = 0;
+
+        bool operator==(const GradeRecord &other) const = default;
+    };
+}
+
+#endif //GRADERECORD_H
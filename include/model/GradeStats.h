@@ -0,0 +1,91 @@
+#ifndef GRADESTATS_H
+#define GRADESTATS_H
+
+#include <cstdint>
+#include <ostream>
+
+namespace model {
+    // GradeStats - сводка по набору оценок: гистограмма оценок от 1 до 5.
+    // Количество и сумма выводятся из гистограммы, поэтому сводка занимает 20 байт
+    // и может храниться в каждом узле дерева дат
+    class GradeStats {
+        std::uint32_t histogram_[5]{};
+
+    public:
+        GradeStats() = default;
+
+        static GradeStats of(int grade);
+
+        GradeStats &operator+=(const GradeStats &other);
+        GradeStats &operator-=(const GradeStats &other);
+        bool operator==(const GradeStats &other) const;
+
+        [[nodiscard]] std::uint32_t count() const;
+        [[nodiscard]] std::uint32_t count(int grade) const;
+        [[nodiscard]] std::uint64_t sum() const;
+        [[nodiscard]] double average() const;
+
+        friend std::ostream &operator<<(std::ostream &os, const GradeStats &stats);
+    };
+
+    inline GradeStats GradeStats::of(const int grade) {
+        GradeStats stats;
+        if (grade >= 1 && grade <= 5)
+            stats.histogram_[grade - 1] = 1;
+        return stats;
+    }
+
+    inline GradeStats &GradeStats::operator+=(const GradeStats &other) {
+        for (int i = 0; i < 5; ++i) {
+            histogram_[i] += other.histogram_[i];
+        }
+        return *this;
+    }
+
+    inline GradeStats &GradeStats::operator-=(const GradeStats &other) {
+        for (int i = 0; i < 5; ++i) {
+            histogram_[i] -= other.histogram_[i];
+        }
+        return *this;
+    }
+
+    inline bool GradeStats::operator==(const GradeStats &other) const {
+        for (int i = 0; i < 5; ++i) {
+            if (histogram_[i] != other.histogram_[i]) return false;
+        }
+        return true;
+    }
+
+    inline std::uint32_t GradeStats::count() const {
+        std::uint32_t total = 0;
+        for (const auto c: histogram_) total += c;
+        return total;
+    }
+
+    inline std::uint32_t GradeStats::count(const int grade) const {
+        return grade >= 1 && grade <= 5 ? histogram_[grade - 1] : 0;
+    }
+
+    inline std::uint64_t GradeStats::sum() const {
+        std::uint64_t total = 0;
+        for (int i = 0; i < 5; ++i) {
+            total += static_cast<std::uint64_t>(histogram_[i]) * (i + 1);
+        }
+        return total;
+    }
+
+    inline double GradeStats::average() const {
+        const auto total = count();
+        return total == 0 ? 0.0 : static_cast<double>(sum()) / total;
+    }
+
+    inline std::ostream &operator<<(std::ostream &os, const GradeStats &stats) {
+        os << "count=" << stats.count() << " avg=" << stats.average() << " [";
+        for (int i = 0; i < 5; ++i) {
+            os << (i ? " " : "") << i + 1 << ':' << stats.histogram_[i];
+        }
+        return os << ']';
+    }
+}
+
+#endif //GRADESTATS_H
@@ -0,0 +1,34 @@
+#ifndef GRADEVIEW_H
+#define GRADEVIEW_H
+
+#include <string>
+
+#include "Date.h"
+#include "GradeRecord.h"
+#include "PersonName.h"
+#include "Student.h"
+
+namespace model {
+    // GradeView - оценка для отображения без сборки Grade: запись хранится по значению,
+    // студент и название предмета - ссылками на данные справочников. Геттеры повторяют Grade,
+    // поэтому таблица выводит GradeView и Grade одним и тем же кодом.
+    // Представление действительно, пока справочники не меняются
+    class GradeView {
+        const Student *student_;
+        GradeRecord record_;
+        const std::string *subject_;
+
+    public:
+        GradeView(const Student &student, const GradeRecord &record, const std::string &subject)
+            : student_(&student), record_(record), subject_(&subject) {
+        }
+
+        [[nodiscard]] const PersonName &get_student_name() const { return student_->get_name(); }
+        [[nodiscard]] Date get_student_birth_date() const { return record_.student_birth_date; }
+        [[nodiscard]] const std::string &get_subject() const { return *subject_; }
+        [[nodiscard]] int get_grade() const { return record_.grade; }
+        [[nodiscard]] Date get_date() const { return record_.date; }
+    };
+}
+
+#endif //GRADEVIEW_H
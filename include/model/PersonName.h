@@ -6,15 +6,18 @@
 #define PERSON_name_H
 
 #include <string>
-#include <algorithm>
+#include <string_view>
 #include <sstream>
 #include <utility>
 
 namespace model {
     class PersonName {
         std::string last_name_{}, first_name_{}, middle_name_{};
+        // ключ сортировки, см. make_collation_key
+        std::string collation_key_{};
 
-        static std::string get_first_three(const std::string &str);
+        static std::string_view first_code_points(std::string_view str, size_t count);
+        void make_collation_key();
 
     public:
         PersonName(std::string last_name, std::string first_name, std::string middle_name);
@@ -27,9 +30,10 @@ namespace model {
 
         friend std::ostream &operator<<(std::ostream &os, const PersonName &pn);
 
-        [[nodiscard]] std::string last_name() const;
-        [[nodiscard]] std::string first_name() const;
-        [[nodiscard]] std::string middle_name() const;
+        [[nodiscard]] const std::string &last_name() const;
+        [[nodiscard]] const std::string &first_name() const;
+        [[nodiscard]] const std::string &middle_name() const;
+        [[nodiscard]] const std::string &collation_key() const;
 
         [[nodiscard]] std::string to_string() const;
         static PersonName parse(const std::string &name);
@@ -40,19 +44,7 @@ namespace model {
     }
 
     inline bool PersonName::operator<(const PersonName &other) const {
-        const std::string this_first_three = get_first_three(last_name_) + get_first_three(first_name_) +
-                                             get_first_three(middle_name_);
-        const std::string other_first_three = get_first_three(other.last_name_) + get_first_three(other.first_name_) +
-                                              get_first_three(other.middle_name_);
-
-        if (this_first_three != other_first_three) {
-            return this_first_three < other_first_three;
-        }
-
-        // recursive calls
-        if (first_name_ != other.first_name_) return first_name_ < other.first_name_;
-        if (last_name_ != other.last_name_) return last_name_ < other.last_name_;
-        return middle_name_ < other.middle_name_;
+        return collation_key_ < other.collation_key_;
     }
 
     inline bool PersonName::operator>(const PersonName &other) const {
@@ -60,31 +52,65 @@ namespace model {
     }
 
     inline bool PersonName::operator==(const PersonName &other) const {
-        return first_name_ == other.first_name_ && last_name_ == other.last_name_ && middle_name_ == other.middle_name_;
+        return collation_key_ == other.collation_key_;
     }
 
     inline bool PersonName::operator!() const {
         return first_name_.empty() && last_name_.empty() && middle_name_.empty();
     }
 
-    inline std::string PersonName::last_name() const {
+    inline const std::string &PersonName::last_name() const {
         return last_name_;
     }
 
-    inline std::string PersonName::first_name() const {
+    inline const std::string &PersonName::first_name() const {
         return first_name_;
     }
 
-    inline std::string PersonName::middle_name() const {
+    inline const std::string &PersonName::middle_name() const {
         return middle_name_;
     }
 
+    inline const std::string &PersonName::collation_key() const {
+        return collation_key_;
+    }
+
     inline std::string PersonName::to_string() const {
-        return last_name_ + " " + first_name_ + " " + middle_name_;
+        std::string out;
+        out.reserve(last_name_.size() + first_name_.size() + middle_name_.size() + 2);
+        out.append(last_name_).append(" ").append(first_name_).append(" ").append(middle_name_);
+        return out;
     }
 
-    inline std::string PersonName::get_first_three(const std::string &str) {
-        return str.substr(0, std::min(3, static_cast<int>(str.length())));
+    // first_code_points возвращает начало строки из count символов UTF-8, не разрезая
+    // многобайтовые символы (кириллица занимает два байта)
+    inline std::string_view PersonName::first_code_points(const std::string_view str, size_t count) {
+        size_t i = 0;
+        for (; i < str.size(); ++i) {
+            // байты вида 10xxxxxx продолжают символ, остальные начинают новый
+            if ((static_cast<unsigned char>(str[i]) & 0xC0) != 0x80 && count-- == 0) break;
+        }
+        return str.substr(0, i);
+    }
+
+    // make_collation_key один раз собирает строку, побайтовое сравнение которой дает тот же
+    // порядок, что и прежнее сравнение: сначала первые три символа фамилии, имени и отчества,
+    // затем имя, фамилия и отчество целиком. Части разделены '\0', который меньше любого
+    // символа, поэтому более короткая часть оказывается раньше. Байтовый порядок UTF-8
+    // совпадает с порядком кодов символов, так что кириллица сравнивается по алфавиту
+    // (кроме ё, которая идет после я, как и при прежнем сравнении std::string)
+    inline void PersonName::make_collation_key() {
+        const auto last3 = first_code_points(last_name_, 3);
+        const auto first3 = first_code_points(first_name_, 3);
+        const auto middle3 = first_code_points(middle_name_, 3);
+
+        collation_key_.clear();
+        collation_key_.reserve(last3.size() + first3.size() + middle3.size() +
+                               first_name_.size() + last_name_.size() + middle_name_.size() + 3);
+        collation_key_.append(last3).append(first3).append(middle3).push_back('\0');
+        collation_key_.append(first_name_).push_back('\0');
+        collation_key_.append(last_name_).push_back('\0');
+        collation_key_.append(middle_name_);
     }
 
     inline PersonName PersonName::parse(const std::string &name) {
@@ -95,16 +121,20 @@ namespace model {
         if (last_name.empty() || first_name.empty() || middle_name.empty())
             throw std::invalid_argument("ФИО введено неправильно");
 
-        return PersonName{last_name, first_name, middle_name};
+        return PersonName{std::move(last_name), std::move(first_name), std::move(middle_name)};
     }
 
     inline PersonName::PersonName(std::string last_name, std::string first_name,
                                   std::string middle_name) :
         last_name_(std::move(last_name)),
         first_name_(std::move(first_name)),
-        middle_name_(std::move(middle_name)) {}
+        middle_name_(std::move(middle_name)) {
+        make_collation_key();
+    }
 
-    inline PersonName::PersonName() = default;
+    inline PersonName::PersonName() {
+        make_collation_key();
+    }
 }
 
 #endif //PERSON_name_H
@@ -20,6 +20,7 @@ namespace model {
     public:
         Student(PersonName name, int class_number, Date birth_date);
         Student(const Student& other);
+        Student(Student&& other) noexcept;
         Student();
 
         bool operator<(const Student &other) const;
@@ -28,8 +29,9 @@ namespace model {
         bool operator!() const;
 
         Student& operator=(const Student& other);
+        Student& operator=(Student&& other) noexcept;
 
-        [[nodiscard]] model::PersonName get_name() const;
+        [[nodiscard]] const model::PersonName &get_name() const;
         [[nodiscard]] int get_class() const;
         [[nodiscard]] Date get_birth_date() const;
 
@@ -64,16 +66,11 @@ namespace model {
         return !name_ && class_ == 0 && !birth_date_;
     }
 
-    inline Student & Student::operator=(const Student &other) {
-        if (this != &other) {
-            name_ = other.name_;
-            class_ = other.class_;
-            birth_date_ = other.birth_date_;
-        }
-        return *this;
-    }
+    inline Student & Student::operator=(const Student &other) = default;
 
-    inline model::PersonName Student::get_name() const {
+    inline Student & Student::operator=(Student &&other) noexcept = default;
+
+    inline const model::PersonName &Student::get_name() const {
         return name_;
     }
 
@@ -140,6 +137,8 @@ namespace model {
 
     inline Student::Student(const Student &other) = default;
 
+    inline Student::Student(Student &&other) noexcept = default;
+
     inline Student::Student() : class_(0) {}
 }
 
@@ -12,6 +12,7 @@
 #include "PersonName.h"
 #include "Student.h"
 #include "Grade.h"
+#include "GradeRecord.h"
 
 namespace model {
     class StudentGrade {
@@ -28,6 +29,7 @@ namespace model {
                      std::string subject, int grade, Date grade_date);
 
         StudentGrade(const Student &student, const Grade &grade);
+        StudentGrade(const Student &student, const GradeRecord &record, const std::string &subject);
 
         StudentGrade();
 
@@ -36,10 +38,10 @@ namespace model {
         bool operator==(const StudentGrade &other) const;
         bool operator!() const;
 
-        [[nodiscard]] PersonName get_student_name() const;
-        [[nodiscard]] std::string get_class() const;
+        [[nodiscard]] const PersonName &get_student_name() const;
+        [[nodiscard]] const std::string &get_class() const;
         [[nodiscard]] Date get_birth_date() const;
-        [[nodiscard]] std::string get_subject() const;
+        [[nodiscard]] const std::string &get_subject() const;
         [[nodiscard]] int get_grade() const;
         [[nodiscard]] Date get_grade_date() const;
 
@@ -68,6 +70,15 @@ namespace model {
           grade_date_(grade_obj.get_date()) {
     }
 
+    inline StudentGrade::StudentGrade(const Student &student, const GradeRecord &record, const std::string &subject)
+        : student_name_(student.get_name()),
+          class_(std::to_string(student.get_class())),
+          birth_date_(student.get_birth_date()),
+          subject_(subject),
+          grade_(record.grade),
+          grade_date_(record.date) {
+    }
+
     inline StudentGrade::StudentGrade() = default;
 
     inline bool StudentGrade::operator<(const StudentGrade &other) const {
@@ -97,10 +108,10 @@ namespace model {
                subject_.empty() && grade_ == 0 && !grade_date_;
     }
 
-    inline PersonName StudentGrade::get_student_name() const { return student_name_; }
-    inline std::string StudentGrade::get_class() const { return class_; }
+    inline const PersonName &StudentGrade::get_student_name() const { return student_name_; }
+    inline const std::string &StudentGrade::get_class() const { return class_; }
     inline Date StudentGrade::get_birth_date() const { return birth_date_; }
-    inline std::string StudentGrade::get_subject() const { return subject_; }
+    inline const std::string &StudentGrade::get_subject() const { return subject_; }
     inline int StudentGrade::get_grade() const { return grade_; }
     inline Date StudentGrade::get_grade_date() const { return grade_date_; }
 
@@ -145,8 +156,8 @@ namespace model {
         }
 
         return StudentGrade{
-            PersonName::parse(s_name), class_name, Date::parse(birth_date_str),
-            subject, grade,
+            PersonName::parse(s_name), std::move(class_name), Date::parse(birth_date_str),
+            std::move(subject), grade,
             Date::parse(grade_date_str)
         };
     }
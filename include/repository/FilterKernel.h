@@ -0,0 +1,115 @@
+#ifndef FILTERKERNEL_H
+#define FILTERKERNEL_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// AVX2-версия ядра собирается только на x86 и выбирается во время работы, если процессор
+// ее поддерживает; остальной код собирается без -mavx2 и запускается на любом x86-64
+#if defined(GRADE_FILTER_AVX2) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define FILTER_KERNEL_HAS_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC разрешает AVX2-интринсики без /arch:AVX2
+#define FILTER_KERNEL_TARGET_AVX2
+#else
+#define FILTER_KERNEL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace repo::kernel {
+    // GradePredicate - условие фильтра по упакованным столбцам (см. Date::pack):
+    // дата оценки в [low_date, high_date], дата рождения студента и номер предмета совпадают
+    struct GradePredicate {
+        std::uint32_t low_date = 0;
+        std::uint32_t high_date = 0;
+        std::uint32_t birth_date = 0;
+        std::uint16_t subject = 0;
+    };
+
+    // select_scalar - переносимая версия без ветвлений: номер строки пишется всегда,
+    // а счетчик сдвигается только для подходящих строк
+    inline size_t select_scalar(const std::uint32_t *dates, const std::uint16_t *subjects,
+                                const std::uint32_t *births, const size_t first, const size_t last,
+                                const GradePredicate &p, std::uint32_t *out) {
+        size_t count = 0;
+        for (size_t i = first; i < last; ++i) {
+            out[count] = static_cast<std::uint32_t>(i);
+            count += (dates[i] >= p.low_date) & (dates[i] <= p.high_date) &
+                     (births[i] == p.birth_date) & (subjects[i] == p.subject);
+        }
+        return count;
+    }
+
+#if defined(FILTER_KERNEL_HAS_AVX2)
+    // cpu_has_avx2 проверяет поддержку AVX2 процессором и ОС (сохранение YMM-регистров)
+    // один раз за запуск
+    inline bool cpu_has_avx2() {
+        static const bool supported = [] {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & 1 << 27) != 0;
+            const bool avx = (info[2] & 1 << 28) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & 1 << 5) != 0;
+#else
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }();
+        return supported;
+    }
+
+    // select_avx2 проверяет по 8 строк за итерацию. Упакованные даты меньше 2^31, поэтому
+    // беззнаковые сравнения можно заменить знаковыми. Маска совпадений переводится
+    // в номера строк обходом установленных битов
+    FILTER_KERNEL_TARGET_AVX2 inline size_t select_avx2(const std::uint32_t *dates, const std::uint16_t *subjects,
+                              const std::uint32_t *births, const size_t first, const size_t last,
+                              const GradePredicate &p, std::uint32_t *out) {
+        const __m256i low = _mm256_set1_epi32(static_cast<int>(p.low_date) - 1);
+        const __m256i high = _mm256_set1_epi32(static_cast<int>(p.high_date) + 1);
+        const __m256i birth = _mm256_set1_epi32(static_cast<int>(p.birth_date));
+        const __m256i subject = _mm256_set1_epi32(p.subject);
+
+        size_t count = 0;
+        size_t i = first;
+        for (; i + 8 <= last; i += 8) {
+            const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dates + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(births + i));
+            const __m256i s = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(subjects + i)));
+
+            __m256i match = _mm256_and_si256(_mm256_cmpgt_epi32(d, low), _mm256_cmpgt_epi32(high, d));
+            match = _mm256_and_si256(match, _mm256_cmpeq_epi32(b, birth));
+            match = _mm256_and_si256(match, _mm256_cmpeq_epi32(s, subject));
+
+            auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+            while (mask != 0) {
+                out[count++] = static_cast<std::uint32_t>(i + std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+        }
+
+        return count + select_scalar(dates, subjects, births, i, last, p, out + count);
+    }
+#endif
+
+    // select записывает в out номера строк [first, last), удовлетворяющих p, и возвращает их
+    // количество. out должен вмещать last - first номеров
+    inline size_t select(const std::uint32_t *dates, const std::uint16_t *subjects,
+                         const std::uint32_t *births, const size_t first, const size_t last,
+                         const GradePredicate &p, std::uint32_t *out) {
+#if defined(FILTER_KERNEL_HAS_AVX2)
+        if (cpu_has_avx2()) return select_avx2(dates, subjects, births, first, last, p, out);
+#endif
+        return select_scalar(dates, subjects, births, first, last, p, out);
+    }
+}
+
+#endif //FILTERKERNEL_H
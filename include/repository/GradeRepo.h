@@ -5,111 +5,358 @@
 #ifndef GRADEREPO_H
 #define GRADEREPO_H
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
 #include <string>
 
 #include "Repository.h"
+#include "GradeStore.h"
+#include "Snapshot.h"
+#include "SortedIndex.h"
+#include "StudentRepo.h"
+#include "SubjectDictionary.h"
+#include "../utils/ExternalSort.h"
 #include "../utils/FileReader.h"
 #include "../avl-tree/AVLTree.h"
 #include "../model/Grade.h"
+#include "../model/GradeRecord.h"
+#include "../model/GradeStats.h"
+#include "../model/GradeView.h"
 #include "list/List.h"
 
 namespace repo {
-    class GradeRepo {
-        Vector<model::Grade> grades_{};
+    // столбцы таблицы оценок, по которым справочник держит отсортированные перестановки
+    enum class GradeColumn : std::uint8_t {
+        Student, BirthDate, Subject, Grade, Date, Count
+    };
 
-        AVLTree<std::string> key_tree_;
-        AVLTree<model::Date> date_tree_;
+    class GradeRepo {
+        // оценки хранятся компактно, со ссылкой на студента по номеру;
+        // построчно или по столбцам - в зависимости от GRADE_STORE_COLUMNAR
+        GradeStore grades_{};
+
+        // справочник студентов, по которому разрешаются номера
+        const StudentRepo *students_ = nullptr;
+        // названия предметов хранятся один раз, записи ссылаются на них по номеру
+        SubjectDictionary subjects_;
+
+        // общий пул для узлов деревьев и блоков их списков id: узлы одного размера
+        // переиспользуются после удаления, не обращаясь к глобальной куче. Пул объявлен
+        // до деревьев, поэтому разрушается после них
+        std::pmr::unsynchronized_pool_resource node_pool_;
+
+        AVLTree<std::string> key_tree_{&node_pool_};
+        // дерево дат хранит в узлах сводку оценок поддерева для статистики по периоду
+        AVLTree<model::Date, model::GradeStats> date_tree_{&node_pool_};
+        // индекс оценок по номеру предмета
+        AVLTree<model::SubjectId> subject_tree_{&node_pool_};
+
+        // перестановки оценок по столбцам таблицы: строятся при первом запросе
+        // и дальше обновляются вместе с grades_
+        std::array<SortedIndex, static_cast<size_t>(GradeColumn::Count)> sorted_{};
 
         ToKey to_key_{};
 
+        template<typename F>
+        void with_key_of(GradeColumn column, F &&f) const;
+
+        [[nodiscard]] model::GradeRecord to_record(const model::Grade &grade, model::SubjectId subject,
+                                                   const std::string &key) const;
+        [[nodiscard]] static model::GradeRecord to_record(const model::Grade &grade, model::SubjectId subject,
+                                                          model::StudentHandle student);
+        [[nodiscard]] model::Grade to_grade(size_t index) const;
+        [[nodiscard]] std::string key_of(const model::GradeRecord &record) const;
+        [[nodiscard]] size_t find_record(const std::string &key, const model::GradeRecord &record) const;
+
     public:
         GradeRepo();
         ~GradeRepo();
 
-        explicit GradeRepo(const std::string &file_path, ToKey to_key);
+        explicit GradeRepo(const std::string &file_path, ToKey to_key, const StudentRepo &students);
+        GradeRepo(SnapshotReader &snapshot, ToKey to_key, const StudentRepo &students);
 
         bool add_grade(model::Grade &grade);
         bool del_grade(const model::Grade &grade);
-        Vector<model::Grade> search_grades(const std::string &key, size_t &steps) const;
+        GradeList search_grades(const std::string &key, size_t &steps) const;
 
         [[nodiscard]] size_t size() const;
-        [[nodiscard]] std::string * keys(size_t& count) const;
+        [[nodiscard]] Vector<std::string> keys() const;
         [[nodiscard]] Vector<model::Grade> grades() const;
+        [[nodiscard]] Vector<model::Grade> grades_by_key() const;
+        [[nodiscard]] model::GradeView view(size_t index) const;
+        [[nodiscard]] std::span<const std::uint32_t> sorted_order(GradeColumn column);
 
         [[nodiscard]] std::string key_tree_structure(bool horizontal) const;
         [[nodiscard]] std::string date_tree_structure(bool horizontal) const;
+        [[nodiscard]] const AVLTree<std::string> &key_tree() const;
+        [[nodiscard]] const AVLTree<model::Date, model::GradeStats> &date_tree() const;
 
         Vector<model::Grade> search_in_date_range(model::Date low, model::Date high, size_t &steps) const;
+        template<typename Callback>
+        void for_each_in_date_range(const model::Date &low, const model::Date &high, size_t &steps,
+                                    Callback &&visit) const;
+        template<typename Callback>
+        void for_each_matching(model::SubjectId subject, const model::Date &birth_date, const model::Date &low,
+                               const model::Date &high, size_t &steps, Callback &&visit) const;
+
+        [[nodiscard]] model::SubjectId subject_id(const std::string &name) const;
+        [[nodiscard]] const std::string &subject_name(model::SubjectId id) const;
+        [[nodiscard]] model::GradeStats stats_in_date_range(const model::Date &low, const model::Date &high) const;
+
+        void write_snapshot(SnapshotWriter &out) const;
+
+        static utils::ExternalSortStats sort_file(const std::string &src, const std::string &dst, ToKey to_key,
+                                                  size_t memory_budget);
     };
 
-    inline GradeRepo::GradeRepo(const std::string &file_path, const ToKey to_key) {
+    inline GradeRepo::GradeRepo(const std::string &file_path, const ToKey to_key, const StudentRepo &students)
+        : students_(&students) {
         std::size_t count = 0;
-        // загружаем оценки в массив
-        grades_ = utils::FileReader::read_file<model::Grade>(file_path, count);
+        // загружаем оценки из файла
+        const auto grades = utils::FileReader::read_file<model::Grade>(file_path, count);
         // прокидываем функцию, которая превращает ФИО + дата рождения (как строка) в ключ
         to_key_ = to_key;
 
-        // дерево ключей
-        key_tree_ = AVLTree<std::string>();
-        // дерево дат для фильтра
-        date_tree_ = AVLTree<model::Date>();
-
-        Vector<model::Grade> unique_grades;
-        
-        for (std::size_t i = 0; i < grades_.size(); ++i) {
-            const auto key = to_key_(grades_[i].get_student_name(), grades_[i].get_student_birth_date().to_string());
-            
-            std::size_t ids_cnt = 0;
-            const auto ids = key_tree_.to_arr(key, ids_cnt, []{});
-            if (ids != nullptr) {
-                for (size_t j = 0; j < ids_cnt; ++j) {
-                    if (unique_grades[ids[j]] == grades_[i]) {
-                        throw std::invalid_argument("Найден дубликат оценки");
+        grades_.reserve(grades.size());
+
+        // ключи собираются заранее: по ним видно, отсортирован ли файл по студентам,
+        // и студенты всех оценок ищутся одним пакетом
+        Vector<std::string> keys;
+        keys.reserve(grades.size());
+        bool sorted = true;
+
+        for (std::size_t i = 0; i < grades.size(); ++i) {
+            auto key = to_key_(grades[i].get_student_name(), grades[i].get_student_birth_date().to_string());
+            if (!keys.empty() && key < keys.back()) sorted = false;
+            keys.push_back(std::move(key));
+        }
+
+        // номер студента разрешается один раз при загрузке
+        Vector<model::StudentHandle> handles(keys.size());
+        students_->find_handles(std::span<const std::string>(keys.data(), keys.size()),
+                                std::span<model::StudentHandle>(handles.data(), handles.size()));
+
+        for (std::size_t i = 0; i < grades.size(); ++i) {
+            // если студента нет - целостность нарушена
+            if (handles[i] == model::kNoStudent) {
+                Slog::info("Целостность данных нарушена",
+                    Slog::opt("ключ", keys[i]));
+                throw std::runtime_error("Оценка отсылает на отсутствующего студента");
+            }
+            grades_.push_back(to_record(grades[i], subjects_.intern(grades[i].get_subject()), handles[i]));
+        }
+
+        if (sorted) {
+            // файл отсортирован по ключу студента (так его пишет перенос журнала): дерево ключей
+            // строится за линейное время, а дубликаты ищутся только среди оценок того же студента
+            for (size_t group = 0; group < keys.size();) {
+                size_t end = group + 1;
+                while (end < keys.size() && keys[end] == keys[group]) ++end;
+
+                for (size_t i = group; i < end; ++i) {
+                    for (size_t j = group; j < i; ++j) {
+                        if (grades_.get(i) == grades_.get(j))
+                            throw std::invalid_argument("Найден дубликат оценки");
                     }
                 }
+                group = end;
+            }
+
+            key_tree_.build_sorted(keys.size(), [&keys](const size_t id) -> const std::string & {
+                return keys[id];
+            });
+        } else {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (find_record(keys[i], grades_.get(i)) < i) {
+                    throw std::invalid_argument("Найден дубликат оценки");
+                }
+                key_tree_.insert(keys[i], static_cast<int>(i), []{});
             }
-            
-            const auto new_index = unique_grades.size();
-            unique_grades.push_back(grades_[i]);
-            
-            key_tree_.insert(key, static_cast<int>(new_index), []{});
-            date_tree_.insert(grades_[i].get_date(), static_cast<int>(new_index));
         }
-        
-        grades_ = unique_grades;
 
-        Slog::info("Справочник оценок инициализирован");
+        for (size_t i = 0; i < grades_.size(); ++i) {
+            const auto record = grades_.get(i);
+            date_tree_.insert(record.date, static_cast<int>(i), model::GradeStats::of(record.grade));
+            subject_tree_.insert(record.subject, static_cast<int>(i));
+        }
+
+        Slog::info("Справочник оценок инициализирован",
+            Slog::opt("отсортирован", sorted ? "да" : "нет"));
     }
 
-    inline GradeRepo::~GradeRepo() = default;
+    // конструктор из снимка: записи читаются готовыми, без разбора текста и проверки дубликатов
+    // (снимок пишется из уже проверенного справочника), а деревья строятся за линейное время
+    // по сохраненному порядку обхода, без вставок с поворотами
+    inline GradeRepo::GradeRepo(SnapshotReader &snapshot, const ToKey to_key, const StudentRepo &students)
+        : students_(&students), to_key_(to_key) {
+        const auto subjects = snapshot.get<std::uint32_t>();
+        for (std::uint32_t i = 0; i < subjects; ++i) {
+            subjects_.intern(snapshot.get_string());
+        }
 
-    inline bool GradeRepo::add_grade(model::Grade& grade) {
-        // такая оценка уже существует? да - выкидываем ошибку
-        // обращаемся по ключу к дереву и получаем все id из списка в массив
-        std::size_t ids_cnt = 0;
-        const auto ids = key_tree_.to_arr(to_key_(grade.get_student_name(),
-                grade.get_student_birth_date().to_string()), ids_cnt, []{});
-        if (ids != nullptr) {
-            for (size_t i = 0; i < ids_cnt; ++i) {
-                if (grades_[ids[i]] == grade) {
-                    return false;
-                }
+        const auto count = snapshot.get<std::uint64_t>();
+        grades_.reserve(count);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            model::GradeRecord record;
+            record.date = model::Date::unpack(snapshot.get<std::uint32_t>());
+            record.student_birth_date = model::Date::unpack(snapshot.get<std::uint32_t>());
+            record.student = snapshot.get<model::StudentHandle>();
+            record.subject = snapshot.get<model::SubjectId>();
+            record.grade = snapshot.get<std::int8_t>();
+
+            if (record.student >= students.size() || record.subject >= subjects_.size())
+                throw std::runtime_error("Снимок справочников поврежден");
+            grades_.push_back(record);
+        }
+
+        // порядок обхода каждого дерева: count id подряд
+        const auto read_order = [&snapshot, count] {
+            Vector<std::uint32_t> order;
+            order.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                const auto id = snapshot.get<std::uint32_t>();
+                if (id >= count) throw std::runtime_error("Снимок справочников поврежден");
+                order.push_back(id);
             }
+            return order;
+        };
+
+        // ключ студента собирается один раз на студента, а не на каждую его оценку
+        Vector<std::string> student_keys;
+        student_keys.reserve(students.size());
+        for (const auto &student: students.view()) {
+            student_keys.push_back(to_key_(student.get_name(), student.get_birth_date().to_string()));
         }
 
+        const auto key_order = read_order();
+        key_tree_.build_ordered({key_order.data(), key_order.size()},
+            [&](const std::uint32_t id) -> const std::string & {
+                return student_keys[students.index(grades_.student(id))];
+            });
+
+        const auto date_order = read_order();
+        date_tree_.build_ordered({date_order.data(), date_order.size()},
+            [this](const std::uint32_t id) { return model::Date::unpack(grades_.date(id)); },
+            [this](const size_t id) { return model::GradeStats::of(grades_.grade(id)); });
+
+        const auto subject_order = read_order();
+        subject_tree_.build_ordered({subject_order.data(), subject_order.size()},
+            [this](const std::uint32_t id) { return grades_.subject(id); });
+
+        Slog::info("Справочник оценок загружен из снимка",
+            Slog::opt("оценки", grades_.size()));
+    }
+
+    inline GradeRepo::~GradeRepo() = default;
+
+    // with_key_of вызывает f с функцией ключа записи по столбцу column. Имена сравниваются
+    // по ключу сортировки ФИО, даты - по упакованному значению
+    template<typename F>
+    void GradeRepo::with_key_of(const GradeColumn column, F &&f) const {
+        switch (column) {
+            case GradeColumn::Student:
+                f([this](const std::uint32_t row) -> const std::string & {
+                    return students_->get(grades_.student(row)).get_name().collation_key();
+                });
+                break;
+            case GradeColumn::BirthDate:
+                f([this](const std::uint32_t row) { return grades_.birth_date(row); });
+                break;
+            case GradeColumn::Subject:
+                f([this](const std::uint32_t row) -> const std::string & {
+                    return subjects_.name(grades_.subject(row));
+                });
+                break;
+            case GradeColumn::Grade:
+                f([this](const std::uint32_t row) { return grades_.grade(row); });
+                break;
+            case GradeColumn::Date:
+                f([this](const std::uint32_t row) { return grades_.date(row); });
+                break;
+            case GradeColumn::Count:
+                throw std::invalid_argument("Неизвестный столбец оценок");
+        }
+    }
+
+    // to_record разрешает студента оценки с ключом key в его номер; если студента нет, номер - kNoStudent.
+    // Ключ передается готовым, чтобы не собирать его второй раз
+    inline model::GradeRecord GradeRepo::to_record(const model::Grade &grade, const model::SubjectId subject,
+                                                   const std::string &key) const {
+        return to_record(grade, subject, students_->find_handle(key));
+    }
+
+    inline model::GradeRecord GradeRepo::to_record(const model::Grade &grade, const model::SubjectId subject,
+                                                   const model::StudentHandle student) {
+        return model::GradeRecord{
+            grade.get_date(),
+            grade.get_student_birth_date(),
+            student,
+            subject,
+            static_cast<std::int8_t>(grade.get_grade())
+        };
+    }
+
+    // to_grade собирает полную оценку по записи: данные студента берутся по номеру
+    inline model::Grade GradeRepo::to_grade(const size_t index) const {
+        const auto record = grades_.get(index);
+        const auto &student = students_->get(record.student);
+
+        model::Grade grade(student.get_name(), student.get_birth_date(), subjects_.name(record.subject),
+                           record.grade, record.date);
+        grade.set_id(index);
+        return grade;
+    }
+
+    inline std::string GradeRepo::key_of(const model::GradeRecord &record) const {
+        const auto &student = students_->get(record.student);
+        return to_key_(student.get_name(), student.get_birth_date().to_string());
+    }
+
+    // find_record ищет запись среди оценок студента с ключом key; возвращает индекс или size()
+    inline size_t GradeRepo::find_record(const std::string &key, const model::GradeRecord &record) const {
+        const auto node = key_tree_.search(key, []{});
+        if (node == nullptr) return grades_.size();
+
+        for (const int id: node->list) {
+            if (grades_.get(id) == record)
+                return id;
+        }
+
+        return grades_.size();
+    }
+
+    inline bool GradeRepo::add_grade(model::Grade& grade) {
+        const auto key = to_key_(grade.get_student_name(), grade.get_student_birth_date().to_string());
+        const auto record = to_record(grade, subjects_.intern(grade.get_subject()), key);
+        if (record.student == model::kNoStudent)
+            throw std::invalid_argument("Студента не существует");
+
+        // такая оценка уже существует? да - ничего не добавляем
+        if (find_record(key, record) != grades_.size())
+            return false;
+
         // обновляем для оценки id (оценка будет добавлена в конец массива)
-        const auto new_size = grades_.size() + 1;
-        grade.set_id(grades_.size());
+        const auto new_index = grades_.size();
+        grade.set_id(new_index);
 
         // добавляем оценку в конец массива
-        grades_.push_back(grade);
+        grades_.push_back(record);
 
         // обновляем деревья, добавляем новый элемент
-        key_tree_.insert(
-            to_key_(grade.get_student_name(),
-                grade.get_student_birth_date().to_string()),
-                new_size - 1, []{});
-        date_tree_.insert(grade.get_date(), new_size - 1, []{});
+        key_tree_.insert(key, static_cast<int>(new_index), []{});
+        date_tree_.insert(record.date, static_cast<int>(new_index), model::GradeStats::of(record.grade));
+        subject_tree_.insert(record.subject, static_cast<int>(new_index));
+
+        // и построенные перестановки
+        for (size_t column = 0; column < sorted_.size(); ++column) {
+            if (!sorted_[column].built()) continue;
+            with_key_of(static_cast<GradeColumn>(column), [&](auto key_of) {
+                sorted_[column].insert(static_cast<std::uint32_t>(new_index), key_of);
+            });
+        }
 
         Slog::info("Оценка добавлена", Slog::opt("данные", grade));
 
@@ -124,55 +371,50 @@ namespace repo {
         const auto key = to_key_(grade.get_student_name(),
                                  grade.get_student_birth_date().to_string());
 
-        // обращаемся по ключу к дереву и получаем все id из списка в массив
-        std::size_t ids_cnt = 0;
-        const auto ids = key_tree_.to_arr(key, ids_cnt, []{});
-
-        // ничего не найдено
-        if (ids_cnt == 0 || ids == nullptr)
-            throw std::invalid_argument(
-                "Список в узле дерева пуст");
+        // студента или предмета нет - и оценки быть не может
+        const auto record = to_record(grade, subjects_.find(grade.get_subject()), key);
+        if (record.student == model::kNoStudent || record.subject == model::kNoSubject)
+            return false;
 
         // находим первый попавшийся элемент, совпадающий с переданным
-        std::size_t idx = grades_.size();
-        for (std::size_t k = 0; k < ids_cnt; ++k)
-            if (grades_[ids[k]] == grade) {
-                idx = ids[k];
-                break;
-            }
+        const std::size_t idx = find_record(key, record);
 
         // ничего не нашли - ничего не удаляем
         if (idx == grades_.size())
             return false;
 
         // нашли оценку, удаляем ее из деревьев
-        const auto& gr = grades_[idx];
-        date_tree_.del(gr.get_date(), idx);
-        key_tree_.del(key, idx);
+        date_tree_.del(record.date, static_cast<int>(idx), model::GradeStats::of(record.grade));
+        key_tree_.del(key, static_cast<int>(idx));
+        subject_tree_.del(record.subject, static_cast<int>(idx));
 
         // если элемент не конечный, значит вместо него встанет последний элемент
-        if (idx != grades_.size() - 1) {
+        const auto last = grades_.size() - 1;
+        if (idx != last) {
             // последний элемент обновляем в деревьях
-            auto last_grade = grades_.back();
-            last_grade.set_id(idx);
-            date_tree_.replace(last_grade.get_date(), grades_.size() - 1, idx);
-            key_tree_.replace(to_key_(
-                last_grade.get_student_name(),
-                last_grade.get_student_birth_date().to_string()
-                ),
-                grades_.size() - 1, idx
-            );
+            const auto last_record = grades_.get(last);
+            date_tree_.replace(last_record.date, static_cast<int>(last), static_cast<int>(idx));
+            key_tree_.replace(key_of(last_record), static_cast<int>(last), static_cast<int>(idx));
+            subject_tree_.replace(last_record.subject, static_cast<int>(last), static_cast<int>(idx));
+        }
+
+        // перестановки обновляются, пока обе записи еще на своих местах
+        for (size_t column = 0; column < sorted_.size(); ++column) {
+            if (!sorted_[column].built()) continue;
+            with_key_of(static_cast<GradeColumn>(column), [&](auto key_of) {
+                sorted_[column].erase_swap(static_cast<std::uint32_t>(idx), static_cast<std::uint32_t>(last), key_of);
+            });
         }
 
         // удаляем оценку из массива, на её место ставим последний элемент
-        grades_.erase_swap(grades_.begin() + idx);
+        grades_.erase_swap(idx);
 
         return true;
     }
 
     // search_grades выполняет поиск оценок соответствующих переданному ключу
     // счетчик steps отображает количество шагов поиска в дереве ключей
-    inline Vector<model::Grade>
+    inline GradeList
     GradeRepo::search_grades(const std::string &key, size_t &steps) const {
         // callback захватывает счетчик и увеличивает его при каждом рекурсивном вызове
         // в дереве
@@ -186,11 +428,11 @@ namespace repo {
         if (node == nullptr) return {};
 
         // узел нашелся, берем из него id (по которым лежат оценки)
-        size_t count = node->list.count();
-        Vector<model::Grade> grades;
-        for (size_t i = 0; i < count; ++i) {
+        GradeList grades;
+        grades.reserve(node->list.count());
+        for (const int id: node->list) {
             // заполняем результат
-            grades.push_back(grades_[node->list[i]]);
+            grades.push_back(to_grade(id));
         }
 
         return grades;
@@ -200,13 +442,96 @@ namespace repo {
         return grades_.size();
     }
 
-    inline std::string * GradeRepo::keys(size_t &count) const {
-        count = key_tree_.get_nodes_count();
+    inline Vector<std::string> GradeRepo::keys() const {
         return key_tree_.keys_in_order();
     }
 
     inline Vector<model::Grade> GradeRepo::grades() const {
-        return grades_;
+        Vector<model::Grade> grades;
+        grades.reserve(grades_.size());
+        for (size_t i = 0; i < grades_.size(); ++i) {
+            grades.push_back(to_grade(i));
+        }
+        return grades;
+    }
+
+    // grades_by_key возвращает оценки в порядке (ключ студента, дата) - в этом порядке
+    // файл загружается с линейным построением дерева ключей
+    inline Vector<model::Grade> GradeRepo::grades_by_key() const {
+        Vector<model::Grade> grades;
+        grades.reserve(grades_.size());
+
+        Vector<int> ids;
+        for (const auto &node: key_tree_) {
+            ids.clear();
+            for (const int id: node.list) {
+                ids.push_back(id);
+            }
+            sort::sortBy(ids.begin(), ids.end(), [this](const int id) { return grades_.date(id); });
+
+            for (const int id: ids) {
+                grades.emplace_back(to_grade(id));
+            }
+        }
+        return grades;
+    }
+
+    // write_snapshot пишет секцию оценок: словарь предметов, записи в порядке хранилища
+    // (студент - индексом в справочнике студентов) и порядок обхода каждого дерева
+    inline void GradeRepo::write_snapshot(SnapshotWriter &out) const {
+        out.put(static_cast<std::uint32_t>(subjects_.size()));
+        for (size_t i = 0; i < subjects_.size(); ++i) {
+            out.put_string(subjects_.name(static_cast<model::SubjectId>(i)));
+        }
+
+        out.put(static_cast<std::uint64_t>(grades_.size()));
+        for (size_t i = 0; i < grades_.size(); ++i) {
+            const auto record = grades_.get(i);
+            out.put(record.date.pack());
+            out.put(record.student_birth_date.pack());
+            out.put(static_cast<model::StudentHandle>(students_->index(record.student)));
+            out.put(record.subject);
+            out.put(record.grade);
+        }
+
+        const auto write_order = [&out](const auto &tree) {
+            for (const auto &node: tree) {
+                for (const int id: node.list) {
+                    out.put(static_cast<std::uint32_t>(id));
+                }
+            }
+        };
+        write_order(key_tree_);
+        write_order(date_tree_);
+        write_order(subject_tree_);
+    }
+
+    // sort_file сортирует файл оценок по (ключ студента, дата), не загружая его целиком:
+    // записи куска вместе с буфером сортировки занимают около memory_budget байт, сверх него -
+    // строки ключей студентов (см. utils::external_sort)
+    inline utils::ExternalSortStats GradeRepo::sort_file(const std::string &src, const std::string &dst,
+                                                         const ToKey to_key, const size_t memory_budget) {
+        return utils::external_sort<model::Grade>(src, dst, [to_key](const model::Grade &grade) {
+            return std::pair{to_key(grade.get_student_name(), grade.get_student_birth_date().to_string()),
+                             grade.get_date().pack()};
+        }, memory_budget);
+    }
+
+    // view возвращает оценку для отображения: строки не копируются, студент и предмет
+    // берутся ссылками из справочника студентов и словаря предметов
+    inline model::GradeView GradeRepo::view(const size_t index) const {
+        const auto record = grades_.get(index);
+        return {students_->get(record.student), record, subjects_.name(record.subject)};
+    }
+
+    // sorted_order возвращает индексы оценок по возрастанию столбца column; перестановка
+    // сортируется только при первом запросе
+    inline std::span<const std::uint32_t> GradeRepo::sorted_order(const GradeColumn column) {
+        auto &index = sorted_[static_cast<size_t>(column)];
+        if (!index.built()) {
+            with_key_of(column, [&](auto key_of) { index.build(grades_.size(), key_of); });
+        }
+        return index.order();
     }
 
     inline std::string GradeRepo::key_tree_structure(const bool horizontal) const {
@@ -217,30 +542,110 @@ namespace repo {
         return horizontal ? date_tree_.structure() : date_tree_.lying_tree();
     }
 
+    inline const AVLTree<std::string> &GradeRepo::key_tree() const {
+        return key_tree_;
+    }
+
+    inline const AVLTree<model::Date, model::GradeStats> &GradeRepo::date_tree() const {
+        return date_tree_;
+    }
+
     // search_in_date_range выполняет поиск оценок в рамках заданного периода
     // счетчик steps отображает количество шагов поиска в дереве дат
     inline Vector<model::Grade> GradeRepo::search_in_date_range(
         model::Date low, model::Date high, size_t &steps) const {
-        size_t counter = 0;
-        Vector indexes(grades_.size(), -1);
+        // сводка дерева дат сразу дает количество оценок в периоде, поэтому результат
+        // резервируется один раз и заполняется прямо при обходе, без промежуточного массива индексов
+        const size_t count = date_tree_.range_aggregate(low, high).count();
+        if (count == 0) {
+            return {};
+        }
+
+        Vector<model::Grade> result;
+        result.reserve(count);
 
         date_tree_.range_search(low, high, [&](const List<int>& list) {
             ++steps;
-            for (size_t i = 0; i < list.count(); ++i) {
-                indexes[counter++] = list[i];
+            for (const int id: list) {
+                result.emplace_back(to_grade(id));
             }
         });
 
-        if (counter == 0) {
-            return {};
+        return result;
+    }
+
+    // for_each_in_date_range вызывает visit(record) для каждой оценки периода, не собирая
+    // полные оценки: данные студента при необходимости берутся по номеру из записи
+    template<typename Callback>
+    void GradeRepo::for_each_in_date_range(const model::Date &low, const model::Date &high, size_t &steps,
+                                           Callback &&visit) const {
+        date_tree_.range_search(low, high, [&](const List<int> &list) {
+            ++steps;
+            for (const int id: list) {
+                visit(grades_.get(id));
+            }
+        });
+    }
+
+    // for_each_matching вызывает visit(record) для оценок по предмету subject студентов с датой
+    // рождения birth_date за период. Обходится меньший из двух индексов: список оценок предмета
+    // или диапазон дерева дат. Если оба кандидата покрывают заметную часть справочника,
+    // дешевле проверить все строки подряд ядром фильтра (kernel::select) кусками по kScanChunk
+    template<typename Callback>
+    void GradeRepo::for_each_matching(const model::SubjectId subject, const model::Date &birth_date,
+                                      const model::Date &low, const model::Date &high, size_t &steps,
+                                      Callback &&visit) const {
+        const auto node = subject_tree_.search(subject, [&steps] { ++steps; });
+        if (node == nullptr) return;
+
+        const auto subject_count = static_cast<size_t>(node->list.count());
+        const auto range_count = static_cast<size_t>(date_tree_.range_aggregate(low, high).count());
+        const kernel::GradePredicate predicate{low.pack(), high.pack(), birth_date.pack(), subject};
+
+        if (std::min(subject_count, range_count) > grades_.size() / 8) {
+            constexpr size_t kScanChunk = 1024;
+            std::uint32_t ids[kScanChunk];
+
+            for (size_t first = 0; first < grades_.size(); first += kScanChunk) {
+                ++steps;
+                const size_t last = std::min(first + kScanChunk, grades_.size());
+                const size_t count = grades_.select(predicate, first, last, ids);
+                for (size_t i = 0; i < count; ++i) {
+                    visit(grades_.get(ids[i]));
+                }
+            }
+            return;
         }
 
-        Vector<model::Grade> result(counter);
-        for (size_t i = 0; i < counter; ++i) {
-            result[i] = grades_[indexes[i]];
+        if (subject_count < range_count) {
+            for (const int idx: node->list) {
+                if (const auto date = grades_.date(idx); date < predicate.low_date || date > predicate.high_date)
+                    continue;
+                if (grades_.birth_date(idx) == predicate.birth_date)
+                    visit(grades_.get(idx));
+            }
+            return;
         }
 
-        return result;
+        for_each_in_date_range(low, high, steps, [&](const model::GradeRecord &record) {
+            if (record.subject == subject && record.student_birth_date == birth_date)
+                visit(record);
+        });
+    }
+
+    // subject_id возвращает номер предмета или kNoSubject, если оценок по нему нет
+    inline model::SubjectId GradeRepo::subject_id(const std::string &name) const {
+        return subjects_.find(name);
+    }
+
+    inline const std::string &GradeRepo::subject_name(const model::SubjectId id) const {
+        return subjects_.name(id);
+    }
+
+    // stats_in_date_range возвращает количество, сумму и гистограмму оценок за период
+    // за O(log n) по сводкам дерева дат, не обращаясь к самим оценкам
+    inline model::GradeStats GradeRepo::stats_in_date_range(const model::Date &low, const model::Date &high) const {
+        return date_tree_.range_aggregate(low, high);
     }
 }
 
@@ -0,0 +1,197 @@
+#ifndef GRADESTORE_H
+#define GRADESTORE_H
+
+#include <cstdint>
+
+#include "FilterKernel.h"
+#include "../model/GradeRecord.h"
+#include "../vector/Vector.h"
+
+namespace repo {
+    // GradeRowStore хранит оценки массивом записей (array-of-structs): вся запись лежит
+    // рядом, что удобно, когда нужна оценка целиком
+    class GradeRowStore {
+        Vector<model::GradeRecord> rows_{};
+
+    public:
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] bool empty() const;
+        void reserve(size_t capacity);
+        void push_back(const model::GradeRecord &record);
+        void erase_swap(size_t index);
+
+        [[nodiscard]] model::GradeRecord get(size_t index) const;
+        [[nodiscard]] model::StudentHandle student(size_t index) const;
+        [[nodiscard]] model::SubjectId subject(size_t index) const;
+        [[nodiscard]] std::int8_t grade(size_t index) const;
+        [[nodiscard]] std::uint32_t date(size_t index) const;
+        [[nodiscard]] std::uint32_t birth_date(size_t index) const;
+
+        size_t select(const kernel::GradePredicate &p, size_t first, size_t last, std::uint32_t *out) const;
+    };
+
+    // GradeColumnStore хранит каждое поле оценки отдельным плотным массивом (struct-of-arrays):
+    // номер студента, номер предмета, оценку и упакованные даты. Фильтр по одному полю читает
+    // только его столбец, так что в кеш попадают лишь нужные байты; запись целиком
+    // собирается по индексу из всех столбцов
+    class GradeColumnStore {
+        Vector<model::StudentHandle> students_{};
+        Vector<model::SubjectId> subjects_{};
+        Vector<std::int8_t> grades_{};
+        // даты оценок и даты рождения студентов в виде Date::pack(), сравниваются как числа
+        Vector<std::uint32_t> dates_{};
+        Vector<std::uint32_t> births_{};
+
+    public:
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] bool empty() const;
+        void reserve(size_t capacity);
+        void push_back(const model::GradeRecord &record);
+        void erase_swap(size_t index);
+
+        [[nodiscard]] model::GradeRecord get(size_t index) const;
+        [[nodiscard]] model::StudentHandle student(size_t index) const;
+        [[nodiscard]] model::SubjectId subject(size_t index) const;
+        [[nodiscard]] std::int8_t grade(size_t index) const;
+        [[nodiscard]] std::uint32_t date(size_t index) const;
+        [[nodiscard]] std::uint32_t birth_date(size_t index) const;
+
+        size_t select(const kernel::GradePredicate &p, size_t first, size_t last, std::uint32_t *out) const;
+    };
+
+    // выбор хранилища задается при сборке опцией GRADE_STORE_COLUMNAR
+#ifdef GRADE_STORE_COLUMNAR
+    using GradeStore = GradeColumnStore;
+#else
+    using GradeStore = GradeRowStore;
+#endif
+
+    inline size_t GradeRowStore::size() const {
+        return rows_.size();
+    }
+
+    inline bool GradeRowStore::empty() const {
+        return rows_.empty();
+    }
+
+    inline void GradeRowStore::reserve(const size_t capacity) {
+        rows_.reserve(capacity);
+    }
+
+    inline void GradeRowStore::push_back(const model::GradeRecord &record) {
+        rows_.push_back(record);
+    }
+
+    inline void GradeRowStore::erase_swap(const size_t index) {
+        rows_.erase_swap(rows_.begin() + index);
+    }
+
+    inline model::GradeRecord GradeRowStore::get(const size_t index) const {
+        return rows_[index];
+    }
+
+    inline model::StudentHandle GradeRowStore::student(const size_t index) const {
+        return rows_[index].student;
+    }
+
+    inline model::SubjectId GradeRowStore::subject(const size_t index) const {
+        return rows_[index].subject;
+    }
+
+    inline std::int8_t GradeRowStore::grade(const size_t index) const {
+        return rows_[index].grade;
+    }
+
+    inline std::uint32_t GradeRowStore::date(const size_t index) const {
+        return rows_[index].date.pack();
+    }
+
+    inline std::uint32_t GradeRowStore::birth_date(const size_t index) const {
+        return rows_[index].student_birth_date.pack();
+    }
+
+    // select у построчного хранилища - скалярный проход по записям
+    inline size_t GradeRowStore::select(const kernel::GradePredicate &p, const size_t first, const size_t last,
+                                        std::uint32_t *out) const {
+        size_t count = 0;
+        for (size_t i = first; i < last; ++i) {
+            const auto &row = rows_[i];
+            const auto date = row.date.pack();
+            out[count] = static_cast<std::uint32_t>(i);
+            count += (date >= p.low_date) & (date <= p.high_date) &
+                     (row.student_birth_date.pack() == p.birth_date) & (row.subject == p.subject);
+        }
+        return count;
+    }
+
+    inline size_t GradeColumnStore::size() const {
+        return students_.size();
+    }
+
+    inline bool GradeColumnStore::empty() const {
+        return students_.empty();
+    }
+
+    inline void GradeColumnStore::reserve(const size_t capacity) {
+        students_.reserve(capacity);
+        subjects_.reserve(capacity);
+        grades_.reserve(capacity);
+        dates_.reserve(capacity);
+        births_.reserve(capacity);
+    }
+
+    inline void GradeColumnStore::push_back(const model::GradeRecord &record) {
+        students_.push_back(record.student);
+        subjects_.push_back(record.subject);
+        grades_.push_back(record.grade);
+        dates_.push_back(record.date.pack());
+        births_.push_back(record.student_birth_date.pack());
+    }
+
+    // erase_swap переносит последнюю запись на место удаленной во всех столбцах сразу
+    inline void GradeColumnStore::erase_swap(const size_t index) {
+        students_.erase_swap(students_.begin() + index);
+        subjects_.erase_swap(subjects_.begin() + index);
+        grades_.erase_swap(grades_.begin() + index);
+        dates_.erase_swap(dates_.begin() + index);
+        births_.erase_swap(births_.begin() + index);
+    }
+
+    inline model::GradeRecord GradeColumnStore::get(const size_t index) const {
+        return model::GradeRecord{
+            model::Date::unpack(dates_[index]),
+            model::Date::unpack(births_[index]),
+            students_[index],
+            subjects_[index],
+            grades_[index]
+        };
+    }
+
+    inline model::StudentHandle GradeColumnStore::student(const size_t index) const {
+        return students_[index];
+    }
+
+    inline model::SubjectId GradeColumnStore::subject(const size_t index) const {
+        return subjects_[index];
+    }
+
+    inline std::int8_t GradeColumnStore::grade(const size_t index) const {
+        return grades_[index];
+    }
+
+    inline std::uint32_t GradeColumnStore::date(const size_t index) const {
+        return dates_[index];
+    }
+
+    inline std::uint32_t GradeColumnStore::birth_date(const size_t index) const {
+        return births_[index];
+    }
+
+    // select у столбцового хранилища передает плотные столбцы векторному ядру фильтра
+    inline size_t GradeColumnStore::select(const kernel::GradePredicate &p, const size_t first, const size_t last,
+                                           std::uint32_t *out) const {
+        return kernel::select(dates_.begin(), subjects_.begin(), births_.begin(), first, last, p, out);
+    }
+}
+
+#endif //GRADESTORE_H
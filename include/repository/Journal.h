@@ -0,0 +1,284 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Snapshot.h"
+#include "../Slog.h"
+#include "../utils/MappedFile.h"
+
+namespace repo {
+    enum class JournalOp : std::uint8_t {
+        AddStudent = 1, DelStudent, AddGrade, DelGrade
+    };
+
+    /**
+    * @brief Журнал изменений справочников, только дописываемый
+    *
+    * Каждое добавление и удаление записывается кадром: код операции, длина, запись в текстовом
+    * формате справочника и контрольная сумма кадра. append только копит кадры в памяти,
+    * commit дописывает все накопленное одной записью в файл - групповая фиксация.
+    *
+    * Журнал применяется поверх базовых файлов (или снимка) при загрузке. Операции - добавить,
+    * если нет, и удалить, если есть, - поэтому повторное применение уже учтенного в базе
+    * префикса журнала дает тот же результат, и сбой между перезаписью базы и обрезкой журнала
+    * ничего не портит. Недописанный хвост после сбоя отбрасывается при чтении.
+    *
+    * Файл начинается с заголовка: метка формата и пути обоих файлов справочников. Журнал,
+    * записанный для другой пары файлов, не применяется (см. replay).
+    */
+    class Journal {
+        std::string path_;
+        // заголовок файла для текущей пары справочников
+        std::string header_;
+        std::ofstream file_;
+        std::string pending_;
+        size_t pending_count_ = 0;
+        // байт, зафиксированных в файле
+        std::uint64_t size_ = 0;
+
+        static constexpr size_t kFrameHeader = sizeof(std::uint8_t) + sizeof(std::uint32_t);
+        static constexpr size_t kFrameChecksum = sizeof(std::uint64_t);
+
+        static constexpr char kMagic[8] = {'S', 'C', 'H', 'J', 'R', 'N', 'L', '\0'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        void open();
+
+        // ReopenGuard открывает файл журнала заново при выходе из области видимости - в том
+        // числе по исключению, чтобы следующий commit не писал в закрытый поток
+        struct ReopenGuard {
+            Journal &journal;
+            explicit ReopenGuard(Journal &j) : journal(j) {}
+            ~ReopenGuard() {
+                try {
+                    journal.open();
+                } catch (const std::exception &e) {
+                    Slog::warn("Не удалось заново открыть журнал",
+                        Slog::opt("файл", journal.path_),
+                        Slog::opt("ошибка", e.what()));
+                }
+            }
+        };
+
+        // header_for собирает заголовок: метка, версия и абсолютные пути файлов справочников
+        static std::string header_for(const std::string &student_path, const std::string &grade_path);
+
+    public:
+        Journal(std::string path, const std::string &student_path, const std::string &grade_path);
+
+        Journal(const Journal &) = delete;
+        Journal &operator=(const Journal &) = delete;
+
+        void append(JournalOp op, const std::string &record);
+
+        // commit дописывает накопленные кадры. При ошибке записи недописанные байты отрезаются,
+        // кадры остаются в очереди до следующей попытки, а исключение передается вызывающему
+        void commit();
+
+        // drop_prefix убирает кадры из первых bytes зафиксированных байт - они уже перенесены
+        // в базу; заголовок остается
+        void drop_prefix(std::uint64_t bytes);
+
+        [[nodiscard]] std::uint64_t size() const;
+        [[nodiscard]] size_t pending() const;
+
+        // path_for - путь журнала рядом с файлом оценок; справочник студентов, к которому
+        // относится журнал, записан в заголовке
+        static std::string path_for(const std::string &grade_path);
+
+        // replay вызывает apply(op, record) для каждого целого кадра журнала path по порядку
+        // и возвращает число кадров. Поврежденный хвост отрезается от файла. Журнал с чужим
+        // заголовком не применяется и переименовывается в path + ".foreign"
+        template<typename Apply>
+        static size_t replay(const std::string &path, const std::string &student_path,
+                             const std::string &grade_path, Apply &&apply);
+    };
+
+    inline Journal::Journal(std::string path, const std::string &student_path, const std::string &grade_path)
+        : path_(std::move(path)), header_(header_for(student_path, grade_path)) {
+        open();
+    }
+
+    inline void Journal::open() {
+        file_.open(path_, std::ios::binary | std::ios::app);
+        if (!file_) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", path_));
+
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path_, error);
+        size_ = error ? 0 : size;
+
+        if (size_ == 0) {
+            file_.write(header_.data(), static_cast<std::streamsize>(header_.size()));
+            file_.flush();
+            if (!file_) throw std::runtime_error(std::format("Не удалось записать файл '{}'", path_));
+            size_ = header_.size();
+        }
+    }
+
+    inline std::string Journal::header_for(const std::string &student_path, const std::string &grade_path) {
+        std::string header(kMagic, sizeof(kMagic));
+        header.append(reinterpret_cast<const char *>(&kVersion), sizeof(kVersion));
+
+        for (const auto &path: {student_path, grade_path}) {
+            const auto absolute = std::filesystem::absolute(path).lexically_normal().string();
+            const auto length = static_cast<std::uint32_t>(absolute.size());
+            header.append(reinterpret_cast<const char *>(&length), sizeof(length));
+            header.append(absolute);
+        }
+
+        return header;
+    }
+
+    inline void Journal::append(const JournalOp op, const std::string &record) {
+        const size_t frame_start = pending_.size();
+        const auto length = static_cast<std::uint32_t>(record.size());
+
+        pending_.push_back(static_cast<char>(op));
+        pending_.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        pending_.append(record);
+
+        const auto frame = std::as_bytes(std::span(pending_.data() + frame_start, pending_.size() - frame_start));
+        const auto checksum = snapshot_checksum(frame);
+        pending_.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+
+        ++pending_count_;
+    }
+
+    inline void Journal::commit() {
+        if (pending_.empty()) return;
+        // поток мог остаться закрытым после неудачной попытки
+        if (!file_.is_open()) open();
+
+        file_.write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+        file_.flush();
+        if (!file_) {
+            // иначе следующие кадры легли бы за оборванным, и replay до них бы не дошел
+            file_.close();
+            std::error_code error;
+            std::filesystem::resize_file(path_, size_, error);
+            throw std::runtime_error(std::format("Не удалось записать файл '{}'", path_));
+        }
+
+        size_ += pending_.size();
+        pending_.clear();
+        pending_count_ = 0;
+    }
+
+    inline void Journal::drop_prefix(const std::uint64_t bytes) {
+        // обрезанный журнал собирается рядом, пока старый открыт и цел: ошибка на этом шаге
+        // оставляет журнал как есть
+        const std::string tmp_path = path_ + ".tmp";
+        {
+            // хвост после bytes - изменения, сделанные во время перезаписи базы; их немного
+            std::ifstream in(path_, std::ios::binary);
+            if (!in) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", path_));
+            in.seekg(static_cast<std::streamoff>(bytes));
+            const std::string tail{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", tmp_path));
+            out.write(header_.data(), static_cast<std::streamsize>(header_.size()));
+            out.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+            out.flush();
+            if (!out) throw std::runtime_error(std::format("Не удалось записать файл '{}'", tmp_path));
+        }
+
+        // открытый файл нельзя заменить на всех платформах; поток открывается заново при любом
+        // исходе - на новом файле или, если замена не удалась, на старом
+        const ReopenGuard reopen(*this);
+        file_.close();
+        std::filesystem::rename(tmp_path, path_);
+    }
+
+    inline std::uint64_t Journal::size() const {
+        return size_;
+    }
+
+    inline size_t Journal::pending() const {
+        return pending_count_;
+    }
+
+    inline std::string Journal::path_for(const std::string &grade_path) {
+        return grade_path + ".journal";
+    }
+
+    template<typename Apply>
+    size_t Journal::replay(const std::string &path, const std::string &student_path,
+                           const std::string &grade_path, Apply &&apply) {
+        std::error_code error;
+        if (!std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) == 0)
+            return 0;
+
+        const auto header = header_for(student_path, grade_path);
+
+        // журнал другой пары файлов (или старого формата) к этим справочникам не относится:
+        // он откладывается в сторону, а не применяется и не дописывается
+        std::string found(header.size(), '\0');
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.read(found.data(), static_cast<std::streamsize>(found.size()));
+            found.resize(static_cast<size_t>(in.gcount()));
+        }
+        if (found != header) {
+            const std::string aside = path + ".foreign";
+            std::filesystem::rename(path, aside);
+            Slog::warn("Журнал записан для других файлов справочников и не применен",
+                Slog::opt("файл", aside),
+                Slog::opt("справочник_студентов", student_path),
+                Slog::opt("справочник_оценок", grade_path));
+            return 0;
+        }
+
+        size_t frames = 0;
+        size_t valid = header.size();
+        {
+            const utils::MappedFile file(path);
+            const auto bytes = file.bytes();
+
+            while (bytes.size() - valid >= kFrameHeader + kFrameChecksum) {
+                std::uint32_t length;
+                std::memcpy(&length, bytes.data() + valid + 1, sizeof(length));
+                if (length > bytes.size() - valid - kFrameHeader - kFrameChecksum) break;
+
+                const auto frame = bytes.subspan(valid, kFrameHeader + length);
+                std::uint64_t checksum;
+                std::memcpy(&checksum, frame.data() + frame.size(), sizeof(checksum));
+                if (checksum != snapshot_checksum(frame)) break;
+
+                const auto op = static_cast<JournalOp>(frame[0]);
+                apply(op, std::string(reinterpret_cast<const char *>(frame.data() + kFrameHeader), length));
+
+                valid += frame.size() + kFrameChecksum;
+                ++frames;
+            }
+
+            if (valid != bytes.size()) {
+                Slog::info("Хвост журнала поврежден и отброшен",
+                    Slog::opt("файл", path),
+                    Slog::opt("байт", bytes.size() - valid));
+            }
+        }
+
+        if (std::filesystem::file_size(path) != valid)
+            std::filesystem::resize_file(path, valid);
+
+        Slog::info("Журнал изменений применен",
+            Slog::opt("файл", path),
+            Slog::opt("операций", frames));
+
+        return frames;
+    }
+}
+
+#endif //JOURNAL_H
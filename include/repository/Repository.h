@@ -6,10 +6,16 @@
 #define REPOSITORY_H
 
 #include <string>
+#include "../model/Grade.h"
 #include "../model/PersonName.h"
+#include "../vector/SmallVector.h"
 
 namespace repo {
     using ToKey = std::string(*)(const model::PersonName &, const std::string &);
+
+    // оценки одного студента: обычно их немного, и результат поиска умещается
+    // во встроенном буфере без обращения к куче
+    using GradeList = SmallVector<model::Grade, 8>;
 }
 
 #endif //REPOSITORY_H
@@ -5,14 +5,25 @@
 #ifndef SCHOOLREPO_H
 #define SCHOOLREPO_H
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <span>
 #include <string>
 
 #include "GradeRepo.h"
+#include "Journal.h"
+#include "Snapshot.h"
 #include "StudentRepo.h"
 #include "Repository.h"
 #include "../model/Student.h"
 #include "../model/StudentGrade.h"
+#include "../sort/Sort.h"
+#include "../utils/Arena.h"
 #include "../utils/FileWriter.h"
+#include "../utils/ThreadPool.h"
 
 namespace repo {
     class SchoolRepo {
@@ -21,87 +32,215 @@ namespace repo {
 
         ToKey to_key_{};
 
+        std::string student_path_;
+        std::string grade_path_;
+
+        // журнал изменений с прошлого переноса в базовые файлы; пуст, пока идет загрузка,
+        // поэтому изменения из журнала при повторном применении в него не попадают
+        std::optional<Journal> journal_;
+
+        // фоновый перенос журнала в базовые файлы: compaction_mark_ - сколько байт журнала
+        // он учитывает. После неудачного переноса compaction_failed_ откладывает следующий
+        // до нового изменения, иначе перенос запускался бы заново каждый кадр
+        std::future<void> compaction_;
+        std::uint64_t compaction_mark_ = 0;
+        bool compaction_requested_ = false;
+        bool compaction_failed_ = false;
+
+        // буфер арены запроса на стеке: его хватает на несколько сотен записей оценок
+        static constexpr size_t kQueryArenaSize = 4096;
+        // изменения фиксируются раз в кадр или, если их много, каждые kGroupCommit операций
+        static constexpr size_t kGroupCommit = 256;
+        // журнал больше kCompactBytes переносится в базовые файлы
+        static constexpr std::uint64_t kCompactBytes = 1u << 20;
+
+        SchoolRepo(std::optional<Snapshot> snapshot, const std::string &student_dir_path,
+                   const std::string &grade_dir_path, ToKey to_key, size_t hash_table_cap, bool use_bloom);
+
+        void journal(JournalOp op, const std::string &record);
+        bool commit_pending();
+        void apply(JournalOp op, const std::string &record);
+        void start_compaction();
+        void finish_compaction(bool wait);
+
+        template<typename T>
+        static void replace_file(const std::string &path, const Vector<T> &records);
+
     public:
         SchoolRepo() = delete;
-        ~SchoolRepo() = default;
+        ~SchoolRepo();
 
         explicit SchoolRepo(
             const std::string &student_dir_path,
             const std::string &grade_dir_path,
             ToKey to_key,
-            size_t hash_table_cap = 0
+            size_t hash_table_cap = 0,
+            bool use_bloom = true
         );
 
         bool add_student(const model::Student &student);
+        bool add_student(model::Student &&student);
         bool del_student(const model::Student &student);
         const model::Student *search_student(const std::string &key, size_t &steps);
+        void share_students();
+        [[nodiscard]] std::optional<model::Student> search_student_shared(const std::string &key) const;
 
         bool add_grade(model::Grade &grade);
+        bool add_grade(model::Grade &&grade);
         bool del_grade(const model::Grade &grade);
         size_t del_grades(const std::string &key);
-        Vector<model::Grade> search_grades(const std::string &key, size_t &steps) const;
+        GradeList search_grades(const std::string &key, size_t &steps) const;
+
+        [[nodiscard]] model::GradeStats grade_stats(const model::Date &start_period, const model::Date &end_period) const;
 
         Vector<model::StudentGrade> get_filtered(const model::Date &student_birth_date, const std::string &subject,
                                                model::Date start_period, model::Date end_period, size_t &steps);
 
-        void save_student_repo(const std::string& path) const;
-        void save_grade_repo(const std::string& path) const;
+        void commit_journal();
+        void close_journal();
 
         static void save_filtered(const std::string &path, const Vector<model::StudentGrade> &student_grades, size_t count);
 
         [[nodiscard]] size_t student_repo_size() const;
         [[nodiscard]] Vector<model::Student> students() const;
+        [[nodiscard]] std::span<const model::Student> student_view() const;
+        [[nodiscard]] std::span<const std::uint32_t> sorted_students(StudentColumn column);
 
         [[nodiscard]] size_t grade_repo_size() const;
         [[nodiscard]] Vector<model::Grade> grades() const;
+        [[nodiscard]] model::GradeView grade_view(size_t index) const;
+        [[nodiscard]] std::span<const std::uint32_t> sorted_grades(GradeColumn column);
 
         [[nodiscard]] std::string key_tree_structure(bool horizontal = false) const;
         [[nodiscard]] std::string date_tree_structure(bool horizontal = false) const;
         [[nodiscard]] std::string table_structure(bool show_only_occupied = true) const;
+
+        // индексы только для чтения - для отладочного инспектора
+        [[nodiscard]] const AVLTree<std::string> &key_tree() const;
+        [[nodiscard]] const AVLTree<model::Date, model::GradeStats> &date_tree() const;
+        [[nodiscard]] const hash::HashTable<std::string, size_t> &student_table() const;
     };
 
+    // справочники загружаются из снимка рядом с файлом оценок, если он снят с текущих версий
+    // файлов, иначе - из текста
     inline SchoolRepo::SchoolRepo(
         const std::string &student_dir_path,
         const std::string &grade_dir_path,
         const ToKey to_key,
-        const size_t hash_table_cap
-    ) : student_repo_(StudentRepo(student_dir_path, to_key, hash_table_cap)),
-        grade_repo_(GradeRepo(grade_dir_path, to_key)),
-        to_key_(to_key) {
-        // проверяем целостность записей
-        size_t count = 0;
-        const auto *keys = grade_repo_.keys(count);
-
-        Slog::info("Проверка целостности данных");
-
-        size_t deleted = 0;
-
-        // затычка (вместо подсчета шагов)
-        size_t tmp = 0;
-        // проходимся по ключам
-        // если ключа нет - выкидываем ошибку (целостность нарушена)
-        for (size_t i = 0; i < count; ++i) {
-            //search_student возвращает Student
-            if (student_repo_.search_student(keys[i], tmp) == nullptr) {
-                Slog::info("Целостность данных нарушена",
-                    Slog::opt("ключ", keys[i]));
-                // все-таки ключа нет, целостность нарушена, выкидываем ошибку
-                throw std::runtime_error("Оценка отсылает на отсутствующего студента");
-            }
-        }
+        const size_t hash_table_cap,
+        const bool use_bloom
+    ) : SchoolRepo(Snapshot::open(Snapshot::path_for(grade_dir_path), student_dir_path, grade_dir_path),
+                   student_dir_path, grade_dir_path, to_key, hash_table_cap, use_bloom) {
+    }
 
+    inline SchoolRepo::SchoolRepo(
+        std::optional<Snapshot> snapshot,
+        const std::string &student_dir_path,
+        const std::string &grade_dir_path,
+        const ToKey to_key,
+        const size_t hash_table_cap,
+        const bool use_bloom
+    ) : student_repo_(snapshot
+                          ? StudentRepo(snapshot->reader(), to_key, hash_table_cap, use_bloom)
+                          : StudentRepo(student_dir_path, to_key, hash_table_cap, use_bloom)),
+        grade_repo_(snapshot
+                        ? GradeRepo(snapshot->reader(), to_key, student_repo_)
+                        : GradeRepo(grade_dir_path, to_key, student_repo_)),
+        to_key_(to_key),
+        student_path_(student_dir_path),
+        grade_path_(grade_dir_path) {
+        // целостность записей проверяется при загрузке оценок: каждая оценка получает номер
+        // своего студента, и оценка без студента приводит к ошибке; снимок пишется только
+        // из проверенных справочников
         Slog::info("Проверка целостности данных завершена",
-            Slog::opt("удалено_ключей", deleted));
+            Slog::opt("источник", snapshot ? "снимок" : "текст"));
+
+        // изменения прошлых запусков, еще не перенесенные в базовые файлы
+        Journal::replay(Journal::path_for(grade_path_), student_path_, grade_path_,
+                        [this](const JournalOp op, const std::string &record) {
+                            apply(op, record);
+                        });
+        journal_.emplace(Journal::path_for(grade_path_), student_path_, grade_path_);
+
+        // без свежего снимка следующий запуск снова разбирал бы текст: первый перенос
+        // журнала запишет снимок в фоне
+        compaction_requested_ = !snapshot;
+    }
+
+    // незавершенный фоновый перенос дожидается окончания записи; журнал при этом
+    // не обрезается, и следующая загрузка применит его поверх новых файлов
+    inline SchoolRepo::~SchoolRepo() {
+        if (compaction_.valid()) compaction_.wait();
+    }
+
+    // journal записывает успешное изменение; при загрузке журнала еще нет
+    inline void SchoolRepo::journal(const JournalOp op, const std::string &record) {
+        if (!journal_) return;
+
+        journal_->append(op, record);
+        compaction_failed_ = false;
+        if (journal_->pending() >= kGroupCommit)
+            commit_pending();
+    }
+
+    // commit_pending фиксирует накопленные изменения. Ошибка записи не прерывает работу:
+    // изменения остаются в очереди журнала и уйдут со следующей фиксацией
+    inline bool SchoolRepo::commit_pending() {
+        try {
+            journal_->commit();
+            return true;
+        } catch (const std::exception &e) {
+            Slog::warn("Не удалось зафиксировать журнал",
+                Slog::opt("операций", journal_->pending()),
+                Slog::opt("ошибка", e.what()));
+            return false;
+        }
+    }
+
+    // apply повторяет операцию журнала. Запись, которую нельзя применить к базе (например,
+    // база менялась в обход журнала), пропускается
+    inline void SchoolRepo::apply(const JournalOp op, const std::string &record) {
+        try {
+            switch (op) {
+                case JournalOp::AddStudent:
+                    add_student(model::Student::parse(record));
+                    break;
+                case JournalOp::DelStudent:
+                    del_student(model::Student::parse(record));
+                    break;
+                case JournalOp::AddGrade:
+                    add_grade(model::Grade::parse(record));
+                    break;
+                case JournalOp::DelGrade:
+                    del_grade(model::Grade::parse(record));
+                    break;
+                default:
+                    throw std::invalid_argument("Неизвестная операция журнала");
+            }
+        } catch (const std::exception &e) {
+            Slog::warn("Операция журнала пропущена",
+                Slog::opt("запись", record),
+                Slog::opt("ошибка", e.what()));
+        }
     }
 
     inline bool SchoolRepo::add_student(const model::Student &student) {
-        return student_repo_.add_student(student);
+        return add_student(model::Student(student));
+    }
+
+    inline bool SchoolRepo::add_student(model::Student &&student) {
+        auto record = student.to_string();
+        const auto added = student_repo_.add_student(std::move(student));
+        if (added) journal(JournalOp::AddStudent, record);
+        return added;
     }
 
     inline bool SchoolRepo::del_student(const model::Student &student) {
         // формируем ключ для проверки связанных записей
         const std::string key = to_key_(student.get_name(), student.get_birth_date().to_string());
         
+        // проверка обязательна: от нее зависит повторное использование номеров студентов
+        // (см. StudentRepo::free_handles_)
         if (size_t tmp = 0; !grade_repo_.search_grades(key, tmp).empty()) {
             // нашли записи в справочнике оценок - выбрасываем ошибку
             throw std::invalid_argument("Для переданного студента найдена запись(-и) в таблице оценок. "
@@ -111,6 +250,7 @@ namespace repo {
         // связанных записей нет - удаляем запись о студенте
         //del_student возвращает bool
         const auto deleted = student_repo_.del_student(student);
+        if (deleted) journal(JournalOp::DelStudent, student.to_string());
 
         Slog::info("Удаление студента",
             Slog::opt("ключ", key),
@@ -131,22 +271,26 @@ namespace repo {
         return student;
     }
 
+    // share_students включает поиск студентов из рабочих потоков; по умолчанию он выключен,
+    // чтобы не держать вторую копию справочника
+    inline void SchoolRepo::share_students() {
+        student_repo_.share_students();
+    }
+
+    // search_student_shared можно вызывать из рабочих потоков, пока UI-поток меняет справочник;
+    // сначала нужно вызвать share_students
+    inline std::optional<model::Student> SchoolRepo::search_student_shared(const std::string &key) const {
+        return student_repo_.search_student_shared(key);
+    }
+
     inline bool SchoolRepo::add_grade(model::Grade &grade) {
         Slog::info("Добавление оценки",
             Slog::opt("данные", grade));
 
-        // проверяем наличие студента
-        // если есть - добавляем, иначе отдаем ошибку
-        size_t tmp = 0;
-        auto *student = student_repo_.search_student(
-            to_key_(grade.get_student_name(), grade.get_student_birth_date().to_string()), tmp
-        );
-        if (student == nullptr) {
-            throw std::invalid_argument("Студента не существует");
-            return false;
-        }
-
+        // наличие студента проверяет справочник оценок, когда разрешает его номер:
+        // если студента нет - выбрасывается ошибка
         const auto deleted = grade_repo_.add_grade(grade);
+        if (deleted) journal(JournalOp::AddGrade, grade.to_string());
 
         Slog::info("Добавление завершено",
             Slog::opt("данные", grade),
@@ -155,11 +299,17 @@ namespace repo {
         return deleted;
     }
 
+    // оценка хранится записью без строк, поэтому временную оценку достаточно передать по ссылке
+    inline bool SchoolRepo::add_grade(model::Grade &&grade) {
+        return add_grade(grade);
+    }
+
     inline bool SchoolRepo::del_grade(const model::Grade &grade) {
         Slog::info("Удаление оценки",
             Slog::opt("данные", grade));
 
         const auto deleted = grade_repo_.del_grade(grade);
+        if (deleted) journal(JournalOp::DelGrade, grade.to_string());
 
         Slog::info("Удаление завершено",
             Slog::opt("успешно", deleted == true ? "да" : "нет"));
@@ -167,7 +317,7 @@ namespace repo {
         return deleted;
     }
 
-    inline Vector<model::Grade> SchoolRepo::search_grades(const std::string &key, size_t &steps) const {
+    inline GradeList SchoolRepo::search_grades(const std::string &key, size_t &steps) const {
         Slog::info("Поиск оценок",
             Slog::opt("ключ", key));
 
@@ -192,41 +342,39 @@ namespace repo {
         if (start_period > end_period)
             throw std::invalid_argument("Период задан с ошибкой");
 
-        size_t count = 0;
-
-        // сначала ищем оценки по дате
-        const auto grades = grade_repo_.search_in_date_range(start_period, end_period, steps);
-
-        if (grades.empty())
+        // предмет переводится в номер один раз; дальше оценки сравниваются по номеру
+        const auto subject_id = grade_repo_.subject_id(subject);
+        if (subject_id == model::kNoSubject)
             return {};
 
-        Vector<model::StudentGrade> result;
-
-        for (const auto & gr : grades) {
-            // фильтрация по дате рождения
-            if (gr.get_student_birth_date() != student_birth_date)
-                continue;
-
-            // фильтрация по предмету
-            if (gr.get_subject() != subject)
-                continue;
+        // отбираем оценки периода по предмету и дате рождения; подходящие записи сначала
+        // собираются в арене запроса, чтобы результат со строками выделить один раз нужного размера
+        utils::Arena<kQueryArenaSize> arena;
+        PmrVector<model::GradeRecord> matched(arena.resource());
 
-            // поиск студента по ключу (ФИО + дата рождения)
-            std::string key = to_key_(gr.get_student_name(), gr.get_student_birth_date().to_string());
-            const model::Student* student = student_repo_.search_student(key, steps);
-            if (student == nullptr)
-                continue;
+        grade_repo_.for_each_matching(subject_id, student_birth_date, start_period, end_period, steps,
+                                      [&](const model::GradeRecord &record) {
+            matched.push_back(record);
+        });
 
-            result.push_back(model::StudentGrade(*student, gr));
-            ++count;
+        if (matched.empty()) {
+            return {};
         }
 
+        // порядок обхода зависит от того, какой индекс выбран, поэтому результат упорядочивается
+        // по дате оценки: упакованная дата - целое, и sortBy сортирует ее поразрядно
+        sort::sortBy(matched.begin(), matched.end(), [](const model::GradeRecord &record) {
+            return record.date.pack();
+        });
 
-        if (count == 0) {
-            return {};
+        // студент берется по номеру из записи оценки прямым обращением к массиву,
+        // без ключей и хеширования
+        Vector<model::StudentGrade> result;
+        result.reserve(matched.size());
+        for (const auto &record: matched) {
+            result.emplace_back(student_repo_.get(record.student), record, subject);
         }
 
-
         Slog::info("Справочник успешно сформирован",
             Slog::opt("дата_рождения", student_birth_date),
             Slog::opt("предмет", subject),
@@ -237,12 +385,90 @@ namespace repo {
         return result;
     }
 
-    inline void SchoolRepo::save_student_repo(const std::string &path) const {
-        utils::FileWriter::write_array(path, student_repo_.students(), student_repo_.size());
+    inline model::GradeStats SchoolRepo::grade_stats(const model::Date &start_period,
+                                                     const model::Date &end_period) const {
+        if (start_period > end_period)
+            throw std::invalid_argument("Период задан с ошибкой");
+
+        const auto stats = grade_repo_.stats_in_date_range(start_period, end_period);
+
+        Slog::info("Статистика за период",
+            Slog::opt("начало_периода", start_period),
+            Slog::opt("конец_периода", end_period),
+            Slog::opt("сводка", stats));
+
+        return stats;
+    }
+
+    // commit_journal фиксирует накопленные изменения одной записью в журнал - вызывается раз
+    // в кадр, - забирает результат завершившегося переноса и запускает новый, если журнал вырос
+    inline void SchoolRepo::commit_journal() {
+        if (!journal_) return;
+
+        const bool committed = commit_pending();
+        finish_compaction(false);
+
+        if (committed && !compaction_.valid() && !compaction_failed_ && (compaction_requested_ || journal_->size() >= kCompactBytes))
+            start_compaction();
     }
 
-    inline void SchoolRepo::save_grade_repo(const std::string &path) const {
-        utils::FileWriter::write_array(path, grade_repo_.grades(), grade_repo_.size());
+    // close_journal фиксирует последние изменения и дожидается фонового переноса. Базовые
+    // файлы при выходе не перезаписываются: сохранение стоит столько, сколько изменений
+    inline void SchoolRepo::close_journal() {
+        if (!journal_) return;
+
+        commit_pending();
+        finish_compaction(true);
+    }
+
+    // start_compaction переносит зафиксированный журнал в базовые файлы. Копии справочников
+    // и нагрузка снимка собираются здесь, в UI-потоке, запись файлов уходит в общий пул.
+    // Изменения, сделанные во время записи, остаются в журнале после отметки.
+    // Оценки пишутся в порядке ключей, чтобы при следующей загрузке дерево ключей строилось
+    // линейно; снимок пишется последним и запоминает размер и время изменения новых файлов
+    inline void SchoolRepo::start_compaction() {
+        compaction_mark_ = journal_->size();
+
+        SnapshotWriter snapshot;
+        student_repo_.write_snapshot(snapshot);
+        grade_repo_.write_snapshot(snapshot);
+
+        compaction_ = utils::ThreadPool::shared().submit(
+            [students = student_repo_.students(), grades = grade_repo_.grades_by_key(),
+                snapshot = std::move(snapshot), student_path = student_path_, grade_path = grade_path_] {
+                replace_file(student_path, students);
+                replace_file(grade_path, grades);
+                snapshot.save(Snapshot::path_for(grade_path), SourceStamp::of(student_path),
+                              SourceStamp::of(grade_path));
+            });
+    }
+
+    // finish_compaction обрезает учтенный в базе префикс журнала, когда перенос завершен.
+    // Если перенос не удался, журнал остается целым и будет применен при следующей загрузке;
+    // новая попытка - после следующего изменения
+    inline void SchoolRepo::finish_compaction(const bool wait) {
+        if (!compaction_.valid()) return;
+        if (!wait && compaction_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+        try {
+            compaction_.get();
+            journal_->drop_prefix(compaction_mark_);
+            compaction_requested_ = false;
+            Slog::info("Журнал перенесен в базовые файлы",
+                Slog::opt("байт", compaction_mark_));
+        } catch (const std::exception &e) {
+            compaction_failed_ = true;
+            Slog::warn("Перенос журнала не удался", Slog::opt("ошибка", e.what()));
+        }
+    }
+
+    // replace_file пишет записи во временный файл и подменяет им path: сбой во время записи
+    // оставляет старый файл целым
+    template<typename T>
+    void SchoolRepo::replace_file(const std::string &path, const Vector<T> &records) {
+        const std::string tmp_path = path + ".tmp";
+        utils::FileWriter::write_array(tmp_path, records, records.size());
+        std::filesystem::rename(tmp_path, path);
     }
 
     inline void SchoolRepo::save_filtered(const std::string &path, const Vector<model::StudentGrade> &student_grades, size_t count) {
@@ -260,6 +486,14 @@ namespace repo {
         return Vector(student_repo_.students());
     }
 
+    inline std::span<const model::Student> SchoolRepo::student_view() const {
+        return student_repo_.view();
+    }
+
+    inline std::span<const std::uint32_t> SchoolRepo::sorted_students(const StudentColumn column) {
+        return student_repo_.sorted_order(column);
+    }
+
     inline size_t SchoolRepo::grade_repo_size() const {
         return grade_repo_.size();
     }
@@ -268,6 +502,14 @@ namespace repo {
         return Vector(grade_repo_.grades());
     }
 
+    inline model::GradeView SchoolRepo::grade_view(const size_t index) const {
+        return grade_repo_.view(index);
+    }
+
+    inline std::span<const std::uint32_t> SchoolRepo::sorted_grades(const GradeColumn column) {
+        return grade_repo_.sorted_order(column);
+    }
+
     inline std::string SchoolRepo::key_tree_structure(const bool horizontal) const {
         return grade_repo_.key_tree_structure(horizontal);
     }
@@ -279,6 +521,18 @@ namespace repo {
     inline std::string SchoolRepo::table_structure(const bool show_only_occupied) const {
         return student_repo_.table_structure(show_only_occupied);
     }
+
+    inline const AVLTree<std::string> &SchoolRepo::key_tree() const {
+        return grade_repo_.key_tree();
+    }
+
+    inline const AVLTree<model::Date, model::GradeStats> &SchoolRepo::date_tree() const {
+        return grade_repo_.date_tree();
+    }
+
+    inline const hash::HashTable<std::string, size_t> &SchoolRepo::student_table() const {
+        return student_repo_.table();
+    }
 }
 
 
@@ -0,0 +1,236 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "../Slog.h"
+#include "../utils/MappedFile.h"
+#include "../vector/Vector.h"
+
+namespace repo {
+    // SourceStamp - размер и время изменения текстового файла справочника. Снимок хранит
+    // отметки файлов, рядом с которыми он записан; если файл с тех пор менялся, снимок устарел
+    struct SourceStamp {
+        std::uint64_t size = 0;
+        std::int64_t mtime = 0;
+
+        bool operator==(const SourceStamp &other) const = default;
+
+        static SourceStamp of(const std::string &path);
+    };
+
+    /**
+    * @brief Заголовок двоичного снимка справочников
+    *
+    * За заголовком идет полезная нагрузка из payload_size байт, ее контрольная сумма - FNV-1a.
+    * Порядок секций нагрузки задают StudentRepo::write_snapshot и GradeRepo::write_snapshot;
+    * при изменении формата увеличивается kVersion, и старые снимки считаются устаревшими.
+    */
+    struct SnapshotHeader {
+        static constexpr char kMagic[8] = {'S', 'C', 'H', 'S', 'N', 'A', 'P', '\0'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        char magic[8]{};
+        std::uint32_t version = 0;
+        std::uint32_t header_size = 0;
+        SourceStamp students;
+        SourceStamp grades;
+        std::uint64_t payload_size = 0;
+        std::uint64_t checksum = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+
+    std::uint64_t snapshot_checksum(std::span<const std::byte> bytes);
+
+    // SnapshotWriter собирает нагрузку снимка в памяти и записывает ее одним файлом
+    class SnapshotWriter {
+        Vector<std::byte> buffer_;
+
+    public:
+        template<typename T>
+        void put(const T &value);
+        void put_string(const std::string &value);
+
+        // save пишет снимок во временный файл и переименовывает его в path: прерванная
+        // запись не оставляет вместо снимка обрезанный файл
+        void save(const std::string &path, const SourceStamp &students, const SourceStamp &grades) const;
+    };
+
+    // SnapshotReader читает нагрузку снимка по порядку, проверяя границы
+    class SnapshotReader {
+        std::span<const std::byte> bytes_;
+        size_t pos_ = 0;
+
+        const std::byte *take(size_t count);
+
+    public:
+        explicit SnapshotReader(std::span<const std::byte> bytes) : bytes_(bytes) {}
+
+        template<typename T>
+        T get();
+        std::string get_string();
+    };
+
+    // Snapshot - проверенный снимок, отображенный в память. Нагрузка читается прямо
+    // из отображения, без промежуточного буфера
+    class Snapshot {
+        utils::MappedFile file_;
+        SnapshotReader reader_;
+
+        Snapshot(utils::MappedFile file, std::span<const std::byte> payload)
+            : file_(std::move(file)), reader_(payload) {
+        }
+
+    public:
+        SnapshotReader &reader() { return reader_; }
+
+        // path_for - путь снимка рядом с файлом оценок
+        static std::string path_for(const std::string &grade_path);
+
+        // open открывает снимок, если он есть, цел и снят с текущих версий обоих файлов;
+        // иначе возвращает nullopt, и справочники загружаются из текста
+        static std::optional<Snapshot> open(const std::string &path, const std::string &student_path,
+                                            const std::string &grade_path);
+    };
+
+    inline SourceStamp SourceStamp::of(const std::string &path) {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        if (error) return {};
+
+        const auto time = std::filesystem::last_write_time(path, error);
+        if (error) return {};
+
+        return {size, static_cast<std::int64_t>(time.time_since_epoch().count())};
+    }
+
+    inline std::uint64_t snapshot_checksum(const std::span<const std::byte> bytes) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const auto byte: bytes) {
+            hash ^= static_cast<std::uint8_t>(byte);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    void SnapshotWriter::put(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            buffer_.push_back(bytes[i]);
+        }
+    }
+
+    inline void SnapshotWriter::put_string(const std::string &value) {
+        put(static_cast<std::uint32_t>(value.size()));
+        for (const char c: value) {
+            buffer_.push_back(static_cast<std::byte>(c));
+        }
+    }
+
+    inline void SnapshotWriter::save(const std::string &path, const SourceStamp &students,
+                                     const SourceStamp &grades) const {
+        SnapshotHeader header;
+        std::memcpy(header.magic, SnapshotHeader::kMagic, sizeof(header.magic));
+        header.version = SnapshotHeader::kVersion;
+        header.header_size = sizeof(SnapshotHeader);
+        header.students = students;
+        header.grades = grades;
+        header.payload_size = buffer_.size();
+        header.checksum = snapshot_checksum({buffer_.data(), buffer_.size()});
+
+        const std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!file) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", tmp_path));
+
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+            if (!file) throw std::runtime_error(std::format("Не удалось записать файл '{}'", tmp_path));
+        }
+        std::filesystem::rename(tmp_path, path);
+
+        Slog::info("Снимок справочников записан",
+            Slog::opt("файл", path),
+            Slog::opt("байт", buffer_.size() + sizeof(header)));
+    }
+
+    inline const std::byte *SnapshotReader::take(const size_t count) {
+        if (count > bytes_.size() - pos_)
+            throw std::runtime_error("Снимок справочников поврежден");
+        const auto *at = bytes_.data() + pos_;
+        pos_ += count;
+        return at;
+    }
+
+    template<typename T>
+    T SnapshotReader::get() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    inline std::string SnapshotReader::get_string() {
+        const auto size = get<std::uint32_t>();
+        const auto *at = take(size);
+        return {reinterpret_cast<const char *>(at), size};
+    }
+
+    inline std::string Snapshot::path_for(const std::string &grade_path) {
+        return grade_path + ".snap";
+    }
+
+    inline std::optional<Snapshot> Snapshot::open(const std::string &path, const std::string &student_path,
+                                                  const std::string &grade_path) {
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) return std::nullopt;
+
+        const auto reject = [&path](const char *reason) {
+            Slog::info("Снимок справочников не используется",
+                Slog::opt("файл", path),
+                Slog::opt("причина", reason));
+            return std::nullopt;
+        };
+
+        try {
+            utils::MappedFile file(path);
+            const auto bytes = file.bytes();
+
+            SnapshotHeader header;
+            if (bytes.size() < sizeof(header)) return reject("файл обрезан");
+            std::memcpy(&header, bytes.data(), sizeof(header));
+
+            if (std::memcmp(header.magic, SnapshotHeader::kMagic, sizeof(header.magic)) != 0)
+                return reject("не снимок");
+            if (header.version != SnapshotHeader::kVersion || header.header_size != sizeof(header))
+                return reject("другая версия формата");
+            if (header.payload_size != bytes.size() - sizeof(header))
+                return reject("файл обрезан");
+            if (header.students != SourceStamp::of(student_path) || header.grades != SourceStamp::of(grade_path))
+                return reject("текстовые файлы изменились");
+
+            const auto payload = bytes.subspan(sizeof(header));
+            if (header.checksum != snapshot_checksum(payload))
+                return reject("контрольная сумма не совпала");
+
+            return Snapshot(std::move(file), payload);
+        } catch (const std::exception &e) {
+            return reject(e.what());
+        }
+    }
+}
+
+#endif //SNAPSHOT_H
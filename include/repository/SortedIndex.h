@@ -0,0 +1,105 @@
+#ifndef SORTEDINDEX_H
+#define SORTEDINDEX_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+#include "../sort/Sort.h"
+#include "../vector/Vector.h"
+
+namespace repo {
+    /**
+    * @brief Перестановка индексов хранилища, упорядоченная по одному столбцу
+    *
+    * order()[k] - индекс в хранилище k-й по возрастанию записи. Перестановка строится один раз
+    * (sort::sortBy, целые ключи - поразрядной сортировкой), а дальше поддерживается вместе
+    * с хранилищем: новая запись вставляется бинарным поиском, а удаление через erase_swap убирает
+    * индекс удаленной записи и переименовывает последнюю. На изменение уходит O(log n) сравнений
+    * и сдвиг хвоста 4-байтных индексов.
+    *
+    * key_of(row) возвращает ключ записи row по текущему содержимому хранилища.
+    * Равные ключи остаются в порядке построения и вставки.
+    */
+    class SortedIndex {
+        Vector<std::uint32_t> order_;
+        bool built_ = false;
+
+        template<typename KeyOf>
+        Vector<std::uint32_t>::iterator locate(std::uint32_t row, KeyOf &key_of);
+
+    public:
+        [[nodiscard]] bool built() const;
+        [[nodiscard]] std::span<const std::uint32_t> order() const;
+
+        // build строит перестановку записей [0, count)
+        template<typename KeyOf>
+        void build(size_t count, KeyOf &&key_of);
+
+        // insert вызывается после добавления записи row в хранилище
+        template<typename KeyOf>
+        void insert(std::uint32_t row, KeyOf &&key_of);
+
+        // erase_swap вызывается до erase_swap хранилища: ключи row и last еще на своих местах
+        template<typename KeyOf>
+        void erase_swap(std::uint32_t row, std::uint32_t last, KeyOf &&key_of);
+    };
+
+    inline bool SortedIndex::built() const {
+        return built_;
+    }
+
+    inline std::span<const std::uint32_t> SortedIndex::order() const {
+        return {order_.data(), order_.size()};
+    }
+
+    template<typename KeyOf>
+    void SortedIndex::build(const size_t count, KeyOf &&key_of) {
+        order_.clear();
+        order_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            order_.push_back(static_cast<std::uint32_t>(i));
+        }
+
+        sort::sortBy(order_.begin(), order_.end(), std::ref(key_of));
+        built_ = true;
+    }
+
+    // locate находит позицию записи row: бинарный поиск сужает до записей с тем же ключом,
+    // среди них row ищется перебором
+    template<typename KeyOf>
+    Vector<std::uint32_t>::iterator SortedIndex::locate(const std::uint32_t row, KeyOf &key_of) {
+        const auto less = [&key_of](const std::uint32_t a, const std::uint32_t b) {
+            return std::less<>{}(key_of(a), key_of(b));
+        };
+
+        const auto [low, high] = std::equal_range(order_.begin(), order_.end(), row, less);
+        const auto pos = std::find(low, high, row);
+        assert(pos != high);
+        return pos;
+    }
+
+    template<typename KeyOf>
+    void SortedIndex::insert(const std::uint32_t row, KeyOf &&key_of) {
+        const auto less = [&key_of](const std::uint32_t a, const std::uint32_t b) {
+            return std::less<>{}(key_of(a), key_of(b));
+        };
+
+        // новая запись встает после всех записей с тем же ключом
+        order_.insert(std::upper_bound(order_.begin(), order_.end(), row, less), row);
+    }
+
+    template<typename KeyOf>
+    void SortedIndex::erase_swap(const std::uint32_t row, const std::uint32_t last, KeyOf &&key_of) {
+        order_.erase(locate(row, key_of));
+        // последняя запись переезжает на место удаленной: ключ тот же, меняется только индекс
+        if (row != last) {
+            *locate(last, key_of) = row;
+        }
+    }
+}
+
+#endif //SORTEDINDEX_H
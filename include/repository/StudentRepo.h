@@ -5,70 +5,243 @@
 #ifndef STUDENTREPO_H
 #define STUDENTREPO_H
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
 
 #include "Repository.h"
+#include "Snapshot.h"
+#include "SortedIndex.h"
 #include "../utils/FileReader.h"
+#include "../model/GradeRecord.h"
 #include "../model/Student.h"
+#include "../hash/BloomFilter.h"
+#include "../hash/ConcurrentHashTable.h"
 #include "../hash/HashTable.h"
 #include "vector/Vector.h"
 
 namespace repo {
+    // столбцы таблицы студентов, по которым справочник держит отсортированные перестановки
+    enum class StudentColumn : std::uint8_t {
+        Name, Class, BirthDate, Count
+    };
+
     class StudentRepo {
         Vector<model::Student> students_{};
 
+        // постоянные номера студентов: slots_[handle] - индекс в students_, handles_[i] - номер
+        // студента students_[i]. Хеш-таблица хранит номер, поэтому уплотнение массива при
+        // удалении не трогает таблицу и ссылки из справочника оценок
+        Vector<size_t> slots_{};
+        Vector<model::StudentHandle> handles_{};
+        // номера удаленных студентов для повторной выдачи. Это безопасно только потому, что
+        // на удаленного студента не ссылается ни одна оценка: SchoolRepo::del_student отказывает,
+        // пока у студента есть оценки. Иначе оценки удаленного студента молча перешли бы
+        // к новому студенту с тем же номером; удалять студентов в обход SchoolRepo нельзя
+        Vector<model::StudentHandle> free_handles_{};
+
         hash::HashTable<std::string, size_t> table_;
 
+        // фильтр Блума перед хеш-таблицей: заведомо отсутствующие ключи отсекаются
+        // без обращения к таблице
+        hash::BloomFilter<std::string> bloom_;
+        bool use_bloom_ = false;
+
+        // копии студентов для чтения из рабочих потоков, пока UI-поток меняет справочник.
+        // Номера вместо копий здесь не годятся: students_ перевыделяется и уплотняется при
+        // удалении, а номер удаленного студента переиспользуется, так что читатель без
+        // блокировки мог бы прочитать перемещаемую или чужую запись. Неизменяемый узел с копией
+        // живет, пока его кто-то читает (эпохи ConcurrentHashTable). Цена - вторая копия
+        // каждого студента, поэтому таблица строится только по share_students
+        std::optional<hash::ConcurrentHashTable<std::string, model::Student>> shared_;
+
+        // перестановки студентов по столбцам таблицы: строятся при первом запросе
+        // и дальше обновляются вместе с students_
+        std::array<SortedIndex, static_cast<size_t>(StudentColumn::Count)> sorted_{};
+
         ToKey to_key_{};
 
+        template<typename F>
+        void with_key_of(StudentColumn column, F &&f) const;
+
+        void rebuild_bloom();
+        void build_indexes(size_t hash_table_cap);
+        model::StudentHandle acquire_handle(size_t index);
+
     public:
         StudentRepo();
         ~StudentRepo();
 
-        explicit StudentRepo(const std::string &file_path, ToKey to_key, size_t hash_table_cap = 0);
+        explicit StudentRepo(const std::string &file_path, ToKey to_key, size_t hash_table_cap = 0,
+                             bool use_bloom = true);
+        StudentRepo(SnapshotReader &snapshot, ToKey to_key, size_t hash_table_cap = 0, bool use_bloom = true);
 
         bool add_student(const model::Student &student);
+        bool add_student(model::Student &&student);
         bool del_student(const model::Student &student);
         const model::Student * search_student(const std::string &key, size_t &steps);
+        void share_students();
+        [[nodiscard]] std::optional<model::Student> search_student_shared(const std::string &key) const;
+
+        [[nodiscard]] model::StudentHandle find_handle(const std::string &key) const;
+        void find_handles(std::span<const std::string> keys, std::span<model::StudentHandle> out) const;
+        [[nodiscard]] const model::Student &get(model::StudentHandle handle) const;
+        [[nodiscard]] size_t index(model::StudentHandle handle) const;
 
         [[nodiscard]] size_t size() const;
         [[nodiscard]] Vector<model::Student> students() const;
+        [[nodiscard]] std::span<const model::Student> view() const;
+        [[nodiscard]] std::span<const std::uint32_t> sorted_order(StudentColumn column);
 
         [[nodiscard]] std::string table_structure(bool show_only_occupied) const;
+        [[nodiscard]] const hash::HashTable<std::string, size_t> &table() const;
+
+        void write_snapshot(SnapshotWriter &out) const;
     };
 
-    inline StudentRepo::StudentRepo(const std::string &file_path, const ToKey to_key, const size_t hash_table_cap) {
+    inline StudentRepo::StudentRepo(const std::string &file_path, const ToKey to_key, const size_t hash_table_cap,
+                                    const bool use_bloom) : use_bloom_(use_bloom) {
         std::size_t count = 0;
         students_ = utils::FileReader::read_file<model::Student>(file_path, count);
         to_key_ = to_key;
 
-        const size_t table_cap = hash_table_cap == 0 ? students_.size() * 2 : hash_table_cap;
-        table_ = hash::HashTable<std::string, size_t>(table_cap);
+        build_indexes(hash_table_cap == 0 ? students_.size() * 2 : hash_table_cap);
+    }
+
+    // конструктор из снимка: студенты читаются из отображенного файла без разбора текста,
+    // а хеш-таблица получает сохраненную ёмкость, если другая не задана явно
+    inline StudentRepo::StudentRepo(SnapshotReader &snapshot, const ToKey to_key, const size_t hash_table_cap,
+                                    const bool use_bloom) : use_bloom_(use_bloom) {
+        to_key_ = to_key;
+
+        const auto saved_cap = snapshot.get<std::uint64_t>();
+        const auto count = snapshot.get<std::uint64_t>();
+        students_.reserve(count);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            const auto class_number = snapshot.get<std::int32_t>();
+            const auto birth_date = model::Date::unpack(snapshot.get<std::uint32_t>());
+            auto last_name = snapshot.get_string();
+            auto first_name = snapshot.get_string();
+            auto middle_name = snapshot.get_string();
+            students_.emplace_back(model::PersonName(std::move(last_name), std::move(first_name),
+                                                     std::move(middle_name)), class_number, birth_date);
+        }
+
+        build_indexes(hash_table_cap == 0 ? static_cast<size_t>(saved_cap) : hash_table_cap);
+    }
+
+    // build_indexes строит хеш-таблицу, номера студентов и фильтр Блума по загруженному массиву
+    inline void StudentRepo::build_indexes(const size_t hash_table_cap) {
+        table_ = hash::HashTable<std::string, size_t>(hash_table_cap);
+
+        Slog::info("Статическая хеш-таблица инициализирована", Slog::opt("ёмкость", hash_table_cap));
 
-        Slog::info("Статическая хеш-таблица инициализирована", Slog::opt("ёмкость", table_cap));
+        slots_.reserve(students_.size());
+        handles_.reserve(students_.size());
 
-        for (std::size_t i = 0; i < students().size(); ++i) {
-            
-            table_.append(to_key_(students_[i].get_name(), students_[i].get_birth_date().to_string()), i);
-            
+        for (std::size_t i = 0; i < students_.size(); ++i) {
+            const auto key = to_key_(students_[i].get_name(), students_[i].get_birth_date().to_string());
+            table_.append(key, acquire_handle(i));
         }
 
+        if (use_bloom_)
+            rebuild_bloom();
+
         Slog::info("Справочник учеников инициализирован");
     }
 
+    // with_key_of вызывает f с функцией ключа студента по столбцу column. Имена сравниваются
+    // по ключу сортировки ФИО, даты - по упакованному значению
+    template<typename F>
+    void StudentRepo::with_key_of(const StudentColumn column, F &&f) const {
+        switch (column) {
+            case StudentColumn::Name:
+                f([this](const std::uint32_t row) -> const std::string & {
+                    return students_[row].get_name().collation_key();
+                });
+                break;
+            case StudentColumn::Class:
+                f([this](const std::uint32_t row) { return students_[row].get_class(); });
+                break;
+            case StudentColumn::BirthDate:
+                f([this](const std::uint32_t row) { return students_[row].get_birth_date().pack(); });
+                break;
+            case StudentColumn::Count:
+                throw std::invalid_argument("Неизвестный столбец студентов");
+        }
+    }
+
+    // rebuild_bloom заново строит фильтр Блума по текущим студентам с запасом на рост
+    inline void StudentRepo::rebuild_bloom() {
+        bloom_.reset(students_.size() * 2);
+
+        for (std::size_t i = 0; i < students_.size(); ++i) {
+            bloom_.insert(to_key_(students_[i].get_name(), students_[i].get_birth_date().to_string()));
+        }
+
+        Slog::info("Фильтр Блума перестроен",
+            Slog::opt("ключей", bloom_.size()),
+            Slog::opt("байт", bloom_.memory()));
+    }
+
     inline StudentRepo::~StudentRepo() = default;
 
+    // acquire_handle выдает номер для студента с индексом index, повторно используя номера
+    // удаленных студентов
+    inline model::StudentHandle StudentRepo::acquire_handle(const size_t index) {
+        model::StudentHandle handle;
+        if (!free_handles_.empty()) {
+            handle = free_handles_.back();
+            free_handles_.pop_back();
+            slots_[handle] = index;
+        } else {
+            handle = static_cast<model::StudentHandle>(slots_.size());
+            slots_.push_back(index);
+        }
+
+        handles_.push_back(handle);
+        return handle;
+    }
+
     inline bool StudentRepo::add_student(const model::Student& student) {
+        return add_student(model::Student(student));
+    }
+
+    // add_student переносит студента в массив без копирования строк; копия делается
+    // только для таблицы рабочих потоков, если она построена
+    inline bool StudentRepo::add_student(model::Student &&student) {
         const std::string key = to_key_(student.get_name(), student.get_birth_date().to_string());
-        const auto new_size = students().size() + 1;
+        const auto handle = acquire_handle(students_.size());
         try {
-            table_.append(key, new_size - 1);
+            table_.append(key, handle);
         } catch (std::overflow_error &e) {
+            // номер не пригодился - возвращаем его
+            handles_.pop_back();
+            free_handles_.push_back(handle);
             throw std::overflow_error(e.what());
             return false;
         }
 
-        students_.push_back(student);
+        if (shared_)
+            shared_->insert(key, student);
+        students_.push_back(std::move(student));
+
+        const auto row = static_cast<std::uint32_t>(students_.size() - 1);
+        for (size_t column = 0; column < sorted_.size(); ++column) {
+            if (!sorted_[column].built()) continue;
+            with_key_of(static_cast<StudentColumn>(column), [&](auto key_of) {
+                sorted_[column].insert(row, key_of);
+            });
+        }
+
+        if (use_bloom_) {
+            bloom_.insert(key);
+            if (bloom_.needs_rebuild())
+                rebuild_bloom();
+        }
 
         return true;
     }
@@ -81,49 +254,183 @@ namespace repo {
         if (entry == nullptr)
             return false; // ключ не найден
 
-        std::size_t idx = *entry->val();
+        const auto handle = static_cast<model::StudentHandle>(*entry->val());
+        const std::size_t idx = slots_[handle];
 
         // проверяем полное совпадение объектов
         if (students_[idx] != student)
             return false; // объекты не идентичны
 
         // удаляем из ХТ
-        table_.del(key, idx);
+        table_.del(key, handle);
+        if (shared_)
+            shared_->erase(key);
+
+        // удаляем из массива, на место удаленного встает последний студент;
+        // его номер не меняется, обновляется только индекс
+        const auto last = students_.size() - 1;
+        for (size_t column = 0; column < sorted_.size(); ++column) {
+            if (!sorted_[column].built()) continue;
+            with_key_of(static_cast<StudentColumn>(column), [&](auto key_of) {
+                sorted_[column].erase_swap(static_cast<std::uint32_t>(idx), static_cast<std::uint32_t>(last), key_of);
+            });
+        }
 
-        // удаляем из массива
+        slots_[handles_[last]] = idx;
+        handles_[idx] = handles_[last];
+        handles_.pop_back();
         students_.erase_swap(students_.begin() + idx);
 
-        // обновляем индексы в хеш-таблице для всех элементов после удаленного
-        for (std::size_t i = idx; i < students().size(); ++i) {
-            table_.update(
-                to_key_(students_[i].get_name(), students_[i].get_birth_date().to_string()),
-                i, []{});
+        slots_[handle] = students_.size();
+        free_handles_.push_back(handle);
+
+        // удаленный ключ остается в фильтре, пока фильтр не будет перестроен
+        if (use_bloom_) {
+            bloom_.erase();
+            if (bloom_.needs_rebuild())
+                rebuild_bloom();
         }
 
         return true;
     }
 
     inline const model::Student * StudentRepo::search_student(const std::string &key, size_t &steps) {
+        // фильтр Блума гарантирует отсутствие ключа - в таблицу не идем
+        if (use_bloom_ && !bloom_.may_contain(key))
+            return nullptr;
+
         auto visit = [&steps]() {
             ++steps;
         };
         const auto node = table_.search(key, visit);
         if (node == nullptr) return nullptr;
 
-        return &students_[*node->val()];
+        return &students_[slots_[*node->val()]];
+    }
+
+    // share_students строит копию справочника для рабочих потоков; дальше она обновляется
+    // вместе со справочником. Вызывается из UI-потока до запуска читателей
+    inline void StudentRepo::share_students() {
+        if (shared_) return;
+
+        shared_.emplace(students_.size() * 2);
+        for (const auto &student: students_) {
+            shared_->insert(to_key_(student.get_name(), student.get_birth_date().to_string()), student);
+        }
+    }
+
+    // search_student_shared - потокобезопасный поиск студента: не берет блокировок и может
+    // выполняться в рабочих потоках одновременно с add_student/del_student.
+    // Возвращает копию, так как запись в справочнике может быть удалена сразу после поиска
+    inline std::optional<model::Student> StudentRepo::search_student_shared(const std::string &key) const {
+        if (!shared_)
+            throw std::logic_error("Копия справочника для рабочих потоков не построена");
+        return shared_->get(key);
+    }
+
+    // find_handle возвращает постоянный номер студента по ключу или kNoStudent
+    inline model::StudentHandle StudentRepo::find_handle(const std::string &key) const {
+        if (use_bloom_ && !bloom_.may_contain(key))
+            return model::kNoStudent;
+
+        const auto node = table_.search(key, []{});
+        return node == nullptr ? model::kNoStudent : static_cast<model::StudentHandle>(*node->val());
+    }
+
+    // find_handles - пакетный find_handle через search_many хеш-таблицы, для загрузки оценок,
+    // где студентов ищут для каждой записи файла. out[i] получает номер для keys[i] или kNoStudent
+    inline void StudentRepo::find_handles(std::span<const std::string> keys,
+                                          std::span<model::StudentHandle> out) const {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("Буфер результатов меньше количества ключей");
+
+        // разбиваем на куски, чтобы буферы помещались на стеке
+        constexpr size_t kChunk = 64;
+        const std::string *candidates[kChunk];
+        size_t positions[kChunk];
+        const hash::HashTable<std::string, size_t>::EntryType *entries[kChunk];
+
+        for (size_t base = 0; base < keys.size(); base += kChunk) {
+            const size_t count = std::min(kChunk, keys.size() - base);
+
+            // в таблицу отправляем только ключи, прошедшие фильтр Блума
+            size_t candidates_count = 0;
+            for (size_t i = 0; i < count; ++i) {
+                out[base + i] = model::kNoStudent;
+                if (use_bloom_ && !bloom_.may_contain(keys[base + i]))
+                    continue;
+                candidates[candidates_count] = &keys[base + i];
+                positions[candidates_count] = base + i;
+                ++candidates_count;
+            }
+
+            if (candidates_count == 0) continue;
+
+            table_.search_many(std::span<const std::string *const>(candidates, candidates_count),
+                               std::span(entries, candidates_count), []{});
+
+            for (size_t i = 0; i < candidates_count; ++i) {
+                if (entries[i] != nullptr)
+                    out[positions[i]] = static_cast<model::StudentHandle>(*entries[i]->val());
+            }
+        }
+    }
+
+    // get возвращает студента по номеру прямым обращением к массиву, без хеширования
+    inline const model::Student &StudentRepo::get(const model::StudentHandle handle) const {
+        return students_[slots_[handle]];
+    }
+
+    // index возвращает текущий индекс студента с номером handle в view()
+    inline size_t StudentRepo::index(const model::StudentHandle handle) const {
+        return slots_[handle];
     }
 
     inline size_t StudentRepo::size() const {
-        return students().size();
+        return students_.size();
     }
 
     inline Vector<model::Student> StudentRepo::students() const {
         return students_;
     }
 
+    // view дает доступ к студентам без копирования; действителен до изменения справочника
+    inline std::span<const model::Student> StudentRepo::view() const {
+        return {students_.data(), students_.size()};
+    }
+
+    // sorted_order возвращает индексы студентов (в порядке view()) по возрастанию столбца
+    // column; перестановка сортируется только при первом запросе
+    inline std::span<const std::uint32_t> StudentRepo::sorted_order(const StudentColumn column) {
+        auto &index = sorted_[static_cast<size_t>(column)];
+        if (!index.built()) {
+            with_key_of(column, [&](auto key_of) { index.build(students_.size(), key_of); });
+        }
+        return index.order();
+    }
+
     inline std::string StudentRepo::table_structure(const bool show_only_occupied) const {
         return table_.structure(show_only_occupied);
     }
+
+    inline const hash::HashTable<std::string, size_t> &StudentRepo::table() const {
+        return table_;
+    }
+
+    // write_snapshot пишет секцию студентов: ёмкость хеш-таблицы и студентов в порядке
+    // массива. При загрузке студент i получает номер i, поэтому ссылки на студентов
+    // в секции оценок записываются индексами
+    inline void StudentRepo::write_snapshot(SnapshotWriter &out) const {
+        out.put(static_cast<std::uint64_t>(table_.capacity()));
+        out.put(static_cast<std::uint64_t>(students_.size()));
+        for (const auto &student: students_) {
+            out.put(static_cast<std::int32_t>(student.get_class()));
+            out.put(student.get_birth_date().pack());
+            out.put_string(student.get_name().last_name());
+            out.put_string(student.get_name().first_name());
+            out.put_string(student.get_name().middle_name());
+        }
+    }
 }
 
 #endif //STUDENTREPO_H
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef SUBJECTDICTIONARY_H
+#define SUBJECTDICTIONARY_H
+
+#include <stdexcept>
+#include <string>
+
+#include "../model/GradeRecord.h"
+#include "../vector/Vector.h"
+
+namespace repo {
+    // SubjectDictionary сопоставляет названиям предметов небольшие номера. Предметов в школе
+    // единицы-десятки, поэтому поиск идет простым проходом по массиву названий: он касается
+    // пары линий кеша и выполняется только при загрузке, добавлении оценки и один раз на
+    // запрос фильтра. Номера не переиспользуются, название хранится в одном экземпляре
+    class SubjectDictionary {
+        Vector<std::string> names_{};
+
+    public:
+        model::SubjectId intern(const std::string &name);
+        [[nodiscard]] model::SubjectId find(const std::string &name) const;
+        [[nodiscard]] const std::string &name(model::SubjectId id) const;
+        [[nodiscard]] size_t size() const;
+    };
+
+    // intern возвращает номер предмета, добавляя его в словарь, если его еще нет
+    inline model::SubjectId SubjectDictionary::intern(const std::string &name) {
+        if (const auto id = find(name); id != model::kNoSubject)
+            return id;
+
+        if (names_.size() >= model::kNoSubject)
+            throw std::overflow_error("Слишком много предметов");
+
+        names_.push_back(name);
+        return static_cast<model::SubjectId>(names_.size() - 1);
+    }
+
+    // find возвращает номер предмета или kNoSubject, если такого предмета нет
+    inline model::SubjectId SubjectDictionary::find(const std::string &name) const {
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (names_[i] == name)
+                return static_cast<model::SubjectId>(i);
+        }
+        return model::kNoSubject;
+    }
+
+    inline const std::string &SubjectDictionary::name(const model::SubjectId id) const {
+        return names_[id];
+    }
+
+    inline size_t SubjectDictionary::size() const {
+        return names_.size();
+    }
+}
+
+#endif //SUBJECTDICTIONARY_H
@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace utils {
+    /*
+    * Arena - монотонная арена для временных данных одного запроса.
+    *
+    * Первые Size байт выделяются из буфера на стеке, дальше - блоками из вышестоящего
+    * ресурса (по умолчанию - глобального). Освобождение отдельных блоков ничего не делает:
+    * вся память возвращается разом при release() или при выходе арены из области видимости.
+    * Контейнеры подключаются к арене через resource(), например PmrVector<int>(arena.resource()).
+    */
+    template<size_t Size>
+    class Arena {
+        alignas(std::max_align_t) std::byte buffer_[Size];
+        std::pmr::monotonic_buffer_resource resource_;
+
+    public:
+        explicit Arena(std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+            : resource_(buffer_, Size, upstream) {
+        }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource *resource() noexcept { return &resource_; }
+
+        // release возвращает всю выделенную память; контейнеры арены к этому моменту
+        // должны быть уничтожены
+        void release() { resource_.release(); }
+    };
+}
+
+#endif //ARENA_H
@@ -0,0 +1,240 @@
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "FileReader.h"
+#include "../Slog.h"
+#include "../sort/Sort.h"
+#include "../vector/Vector.h"
+
+namespace utils {
+    /**
+    * @brief Дерево проигравших для слияния k отсортированных последовательностей
+    *
+    * Листья - номера последовательностей, во внутренних узлах хранится проигравший в сравнении
+    * на этом узле, в tree_[0] - общий победитель. После того как победитель сдвинулся на следующий
+    * элемент, adjust проходит только путь от его листа до корня: log2(k) сравнений на элемент
+    * вместо k - 1 у линейного выбора минимума.
+    *
+    * beats(a, b) - true, если голова последовательности a должна выйти раньше головы b;
+    * закончившиеся последовательности должны проигрывать всем.
+    */
+    template<typename Beats>
+    class LoserTree {
+        static constexpr size_t kEmpty = static_cast<size_t>(-1);
+
+        Vector<size_t> tree_;
+        size_t k_;
+        Beats beats_;
+
+    public:
+        LoserTree(const size_t k, Beats beats) : tree_(k, kEmpty), k_(k), beats_(std::move(beats)) {
+            // при построении первый пришедший в узел лист остается в нем, второй соревнуется с ним
+            for (size_t leaf = k_; leaf-- > 0;) {
+                adjust(leaf);
+            }
+        }
+
+        [[nodiscard]] size_t winner() const { return tree_[0]; }
+
+        // adjust проводит лист leaf от его места до корня, оставляя в узлах проигравших
+        void adjust(size_t leaf) {
+            for (size_t node = (leaf + k_) / 2; node > 0; node /= 2) {
+                if (tree_[node] == kEmpty) {
+                    tree_[node] = leaf;
+                    return;
+                }
+                if (beats_(tree_[node], leaf)) std::swap(leaf, tree_[node]);
+            }
+            tree_[0] = leaf;
+        }
+    };
+
+    struct ExternalSortStats {
+        size_t items = 0;
+        size_t runs = 0;
+    };
+
+    /**
+    * @brief Внешняя сортировка текстового файла записей T
+    *
+    * Файл читается кусками примерно по memory_budget байт (detail::read_items), каждый кусок
+    * сортируется в памяти устойчивой параллельной сортировкой по ключу proj(запись) и сбрасывается
+    * во временный файл-серию рядом с dst. В бюджет куска входит и буфер слияния parallelStableSort,
+    * поэтому запись стоит 2 * sizeof(KeyedRecord) плюс длина ее строки. Динамическая память самого
+    * ключа (например, строки) не учитывается: с таким ключом пик может превысить бюджет на его объем. Затем серии сливаются деревом проигравших: на каждую
+    * серию держится буфер в memory_budget / (серий + 1) байт. Если кусок один, он пишется в dst
+    * сразу. Сортировка устойчива: записи с равными ключами остаются в порядке исходного файла.
+    *
+    * Ключ вычисляется один раз на запись при сортировке куска и один раз при слиянии.
+    * Временные файлы удаляются и при ошибке.
+    */
+    template<Parsable T, typename Proj>
+    ExternalSortStats external_sort(const std::string &src, const std::string &dst, Proj proj,
+                                    size_t memory_budget = 64u << 20);
+
+    namespace detail {
+        template<typename T, typename Key>
+        struct KeyedRecord {
+            Key key{};
+            T record{};
+        };
+
+        // RunFiles удаляет временные серии при выходе из области видимости
+        struct RunFiles {
+            Vector<std::filesystem::path> paths;
+
+            ~RunFiles() {
+                for (const auto &path: paths) {
+                    std::error_code ignored;
+                    std::filesystem::remove(path, ignored);
+                }
+            }
+        };
+
+        template<typename T, typename Key>
+        void write_run(const std::filesystem::path &path, const Vector<KeyedRecord<T, Key>> &items) {
+            std::ofstream file(path);
+            if (!file) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", path.string()));
+            for (size_t i = 0; i < items.size(); ++i) {
+                file << items[i].record.to_string();
+                if (i + 1 != items.size()) file << '\n';
+            }
+        }
+
+        // read_items дочитывает записи в items, пока их объем не превысит max_bytes, и сразу
+        // вычисляет ключ - отдельный вектор записей рядом с items не нужен. Объем записи - сама
+        // запись с ключом, место под нее в буфере слияния сортировки и длина строки.
+        // Возвращает количество учтенных байт; 0 - поток закончился
+        template<typename T, typename Key, typename Proj>
+        size_t read_items(std::istream &in, Vector<KeyedRecord<T, Key>> &items, Proj &proj, const size_t max_bytes) {
+            size_t bytes = 0;
+            std::string line;
+
+            while (bytes < max_bytes && std::getline(in, line)) {
+                if (line.empty()) continue;
+                bytes += 2 * sizeof(KeyedRecord<T, Key>) + line.size();
+                T record = T::parse(line);
+                Key key = std::invoke(proj, std::as_const(record));
+                items.emplace_back(KeyedRecord<T, Key>{std::move(key), std::move(record)});
+            }
+            return bytes;
+        }
+
+        // Run - поток серии с буфером прочитанных записей и ключом текущей
+        template<typename T, typename Key>
+        struct Run {
+            std::ifstream in;
+            Vector<T> buffer;
+            size_t pos = 0;
+            Key key{};
+            bool done = false;
+        };
+
+        template<typename T, typename Key, typename Proj>
+        void advance(Run<T, Key> &run, Proj &proj, const size_t buffer_bytes) {
+            if (++run.pos >= run.buffer.size()) {
+                run.buffer.clear();
+                run.pos = 0;
+                FileReader::read_chunk(run.in, run.buffer, buffer_bytes);
+                if (run.buffer.empty()) {
+                    run.done = true;
+                    return;
+                }
+            }
+            run.key = std::invoke(proj, run.buffer[run.pos]);
+        }
+    }
+
+    template<Parsable T, typename Proj>
+    ExternalSortStats external_sort(const std::string &src, const std::string &dst, Proj proj,
+                                    const size_t memory_budget) {
+        using Key = std::remove_cvref_t<std::invoke_result_t<Proj &, const T &>>;
+        using Item = detail::KeyedRecord<T, Key>;
+
+        std::ifstream in(src);
+        if (!in) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", src));
+
+        ExternalSortStats stats;
+        detail::RunFiles runs;
+
+        // первая фаза: куски сортируются в памяти и сбрасываются в серии
+        Vector<Item> items;
+        while (detail::read_items(in, items, proj, memory_budget) != 0) {
+            sort::parallelStableSort(items.begin(), items.end(), std::less<>{}, &Item::key);
+
+            auto path = std::filesystem::path(dst);
+            path += ".run" + std::to_string(runs.paths.size());
+            detail::write_run(path, items);
+            runs.paths.push_back(std::move(path));
+            stats.items += items.size();
+            items.clear();
+        }
+        stats.runs = runs.paths.size();
+
+        if (stats.runs <= 1) {
+            if (stats.runs == 1) {
+                std::filesystem::rename(runs.paths[0], dst);
+                runs.paths.clear();
+            } else if (std::ofstream empty(dst); !empty) {
+                throw std::runtime_error(std::format("Не удалось открыть файл '{}'", dst));
+            }
+            return stats;
+        }
+
+        // вторая фаза: k-путевое слияние серий деревом проигравших
+        const size_t buffer_bytes = std::max<size_t>(memory_budget / (stats.runs + 1), 4096);
+        Vector<detail::Run<T, Key>> streams;
+        streams.reserve(stats.runs);
+        for (const auto &path: runs.paths) {
+            auto &run = streams.emplace_back();
+            run.in.open(path);
+            if (!run.in) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", path.string()));
+            run.pos = static_cast<size_t>(-1);
+            detail::advance(run, proj, buffer_bytes);
+        }
+
+        // при равных ключах раньше выходит серия с меньшим номером - она взята из начала файла
+        auto beats = [&streams](const size_t a, const size_t b) {
+            if (streams[a].done) return false;
+            if (streams[b].done) return true;
+            if (streams[a].key < streams[b].key) return true;
+            if (streams[b].key < streams[a].key) return false;
+            return a < b;
+        };
+        LoserTree tree(stats.runs, beats);
+
+        std::ofstream out(dst);
+        if (!out) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", dst));
+
+        bool first = true;
+        while (!streams[tree.winner()].done) {
+            auto &run = streams[tree.winner()];
+            if (!first) out << '\n';
+            out << run.buffer[run.pos].to_string();
+            first = false;
+
+            detail::advance(run, proj, buffer_bytes);
+            tree.adjust(tree.winner());
+        }
+
+        Slog::info("Внешняя сортировка завершена",
+            Slog::opt("файл", dst),
+            Slog::opt("записей", stats.items),
+            Slog::opt("серий", stats.runs));
+
+        return stats;
+    }
+}
+
+#endif //EXTERNALSORT_H
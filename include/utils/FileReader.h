@@ -5,6 +5,7 @@
 #ifndef FILEREADER_H
 #define FILEREADER_H
 #include <fstream>
+#include <istream>
 #include <string>
 
 #include "../Slog.h"
@@ -29,6 +30,9 @@ namespace utils {
     public:
         template<Parsable T>
         static Vector<T> read_file(const std::string &file_path, size_t& out_size);
+
+        template<Parsable T>
+        static size_t read_chunk(std::istream &in, Vector<T> &out, size_t max_bytes);
     };
 
     template<Parsable T>
@@ -53,14 +57,32 @@ namespace utils {
         file.seekg(0);
 
         Vector<T> arr{};
+        arr.reserve(out_size);
         std::size_t idx = 0;
 
         while (idx < out_size && std::getline(file, line)) {
             if (line.empty()) continue;
-            arr.push_back(T::parse(line));
+            arr.emplace_back(T::parse(line));
         }
         return arr;
     }
+
+    // read_chunk дочитывает из потока записи, пока их объем не превысит max_bytes, и добавляет
+    // их в out. Объем записи оценивается как sizeof(T) плюс длина строки - этого достаточно,
+    // чтобы ограничить память при обработке файлов, которые не помещаются в нее целиком.
+    // Возвращает количество прочитанных байт; 0 - поток закончился
+    template<Parsable T>
+    size_t FileReader::read_chunk(std::istream &in, Vector<T> &out, const size_t max_bytes) {
+        size_t bytes = 0;
+        std::string line;
+
+        while (bytes < max_bytes && std::getline(in, line)) {
+            if (line.empty()) continue;
+            bytes += sizeof(T) + line.size();
+            out.emplace_back(T::parse(line));
+        }
+        return bytes;
+    }
 }
 
 #endif //FILEREADER_H
@@ -16,11 +16,11 @@ namespace utils {
         static void write_file(const std::string &file_path, const std::string &to_write);
 
         template<typename T>
-        static void write_array(const std::string &file_path, Vector<T> arr, size_t count);
+        static void write_array(const std::string &file_path, const Vector<T> &arr, size_t count);
     };
 
     template<typename T>
-    void FileWriter::write_array(const std::string &file_path, Vector<T> arr, const size_t count) {
+    void FileWriter::write_array(const std::string &file_path, const Vector<T> &arr, const size_t count) {
         std::ofstream file(file_path);
         if (!file) throw std::runtime_error(std::format("Не удалось открыть файл '{}'", file_path));
         for (size_t i = 0; i < count; ++i) {
@@ -0,0 +1,165 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+    /*
+    * MappedFile - файл, отображенный в память только для чтения.
+    *
+    * Содержимое доступно через bytes() без копирования: страницы подгружаются ОС по мере
+    * обращения. Отображение снимается в деструкторе. Пустой файл отображается в пустой span.
+    */
+    class MappedFile {
+        const std::byte *data_ = nullptr;
+        size_t size_ = 0;
+
+#ifdef _WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+
+        void close() noexcept;
+
+    public:
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        [[nodiscard]] std::span<const std::byte> bytes() const;
+        [[nodiscard]] size_t size() const;
+    };
+
+#ifdef _WIN32
+    inline MappedFile::MappedFile(const std::string &path) {
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+            throw std::runtime_error(std::format("Не удалось открыть файл '{}'", path));
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file_, &size)) {
+            close();
+            throw std::runtime_error(std::format("Не удалось определить размер файла '{}'", path));
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ == 0) return;
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr)
+            data_ = static_cast<const std::byte *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr) {
+            close();
+            throw std::runtime_error(std::format("Не удалось отобразить файл '{}'", path));
+        }
+    }
+
+    inline void MappedFile::close() noexcept {
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        data_ = nullptr;
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+        size_ = 0;
+    }
+
+    inline MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          file_(std::exchange(other.file_, INVALID_HANDLE_VALUE)), mapping_(std::exchange(other.mapping_, nullptr)) {
+    }
+
+    inline MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+        }
+        return *this;
+    }
+#else
+    inline MappedFile::MappedFile(const std::string &path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw std::runtime_error(std::format("Не удалось открыть файл '{}'", path));
+
+        struct stat info{};
+        if (::fstat(fd_, &info) != 0) {
+            close();
+            throw std::runtime_error(std::format("Не удалось определить размер файла '{}'", path));
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ == 0) return;
+
+        void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            throw std::runtime_error(std::format("Не удалось отобразить файл '{}'", path));
+        }
+        data_ = static_cast<const std::byte *>(mapped);
+    }
+
+    inline void MappedFile::close() noexcept {
+        if (data_ != nullptr) ::munmap(const_cast<std::byte *>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+        data_ = nullptr;
+        fd_ = -1;
+        size_ = 0;
+    }
+
+    inline MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          fd_(std::exchange(other.fd_, -1)) {
+    }
+
+    inline MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+#endif
+
+    inline MappedFile::~MappedFile() {
+        close();
+    }
+
+    inline std::span<const std::byte> MappedFile::bytes() const {
+        return {data_, size_};
+    }
+
+    inline size_t MappedFile::size() const {
+        return size_;
+    }
+}
+
+#endif //MAPPEDFILE_H
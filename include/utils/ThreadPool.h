@@ -0,0 +1,148 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/Vector.h"
+
+namespace utils {
+    /**
+    * @brief Пул потоков фиксированного размера
+    *
+    * Задачи ставятся в общую очередь и выполняются рабочими потоками в порядке поступления.
+    * submit возвращает std::future с результатом задачи; parallel_for делит count частей работы
+    * между пулом и вызывающим потоком и ждет их завершения.
+    *
+    * Ожидать задачи пула из задачи того же пула нельзя: если все рабочие потоки ждут,
+    * выполнять ожидаемое некому. Поэтому parallel_for вызывается только извне пула.
+    */
+    class ThreadPool {
+        Vector<std::thread> workers_;
+        std::queue<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        bool stopping_ = false;
+
+        void work();
+
+    public:
+        explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        [[nodiscard]] size_t size() const;
+
+        template<typename F>
+        std::future<std::invoke_result_t<F>> submit(F &&task);
+
+        template<typename F>
+        void parallel_for(size_t count, F &&body);
+
+        // shared - общий пул приложения, создается при первом обращении
+        static ThreadPool &shared();
+    };
+
+    inline ThreadPool::ThreadPool(const size_t threads) {
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    inline ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto &worker: workers_) {
+            worker.join();
+        }
+    }
+
+    // work выполняет задачи, пока пул не остановлен; оставшиеся в очереди задачи
+    // дорабатываются до выхода
+    inline void ThreadPool::work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    inline size_t ThreadPool::size() const {
+        return workers_.size();
+    }
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> ThreadPool::submit(F &&task) {
+        using Result = std::invoke_result_t<F>;
+
+        // std::function требует копируемую задачу, поэтому packaged_task хранится в shared_ptr
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        auto future = packaged->get_future();
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.emplace([packaged] { (*packaged)(); });
+        }
+        ready_.notify_one();
+        return future;
+    }
+
+    // parallel_for вызывает body(i) для i из [0, count): части 1..count-1 уходят в пул,
+    // часть 0 выполняет вызывающий поток. Исключение первой упавшей части пробрасывается
+    // после завершения всех частей
+    template<typename F>
+    void ThreadPool::parallel_for(const size_t count, F &&body) {
+        if (count == 0) return;
+
+        Vector<std::future<void>> pending;
+        pending.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i) {
+            pending.emplace_back(submit([&body, i] { body(i); }));
+        }
+
+        std::exception_ptr error;
+        try {
+            body(0);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        for (auto &future: pending) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    inline ThreadPool &ThreadPool::shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+}
+
+#endif //THREADPOOL_H
@@ -0,0 +1,528 @@
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+* @brief Вектор с N элементами во встроенном буфере
+*
+* Пока элементов не больше N, они лежат внутри самого объекта и куча не используется;
+* при переполнении элементы переносятся в динамический блок и дальше вектор растет как Vector.
+* API повторяет Vector, поэтому SmallVector подходит для коротких результатов запросов:
+* списков id и оценок одного студента.
+*/
+template<typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallVector {
+    static_assert(N > 0, "SmallVector: встроенный буфер не может быть пустым");
+
+public:
+    using iterator = T *;
+    using const_iterator = const T *;
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+private:
+    Allocator alloc_;
+    T *data_;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) std::byte inline_[N * sizeof(T)];
+
+    static constexpr bool kTrivial = std::is_trivially_copyable_v<T>;
+    // динамический блок другого вектора можно забрать, только если освободить его
+    // сможет наш аллокатор
+    static constexpr bool kStealOnMove =
+            alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value;
+
+    [[nodiscard]] T *inline_data() noexcept;
+    [[nodiscard]] bool is_inline() const noexcept;
+    [[nodiscard]] size_t grow_capacity(size_t min_capacity) const;
+    void relocate(T *from, size_t count, T *to);
+    void reallocate(size_t new_capacity);
+    void release() noexcept;
+    void steal(SmallVector &other);
+
+public:
+    SmallVector();
+    explicit SmallVector(const Allocator &alloc);
+    SmallVector(const SmallVector &other);
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>);
+    SmallVector(size_t size, const T &value);
+    explicit SmallVector(size_t size);
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    T *data() noexcept;
+    const T *data() const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] size_t capacity() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    void reserve(size_t new_capacity);
+    void shrink_to_fit();
+    void resize(size_t n);
+    void push_back(const T &value);
+    void push_back(T &&value);
+    template<typename... Args>
+    T &emplace_back(Args &&... args);
+    void pop_back() noexcept;
+    iterator del(const T &value);
+    iterator insert(const_iterator pos, const T &value);
+    iterator insert(const_iterator pos, T &&value);
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args &&... args);
+
+    SmallVector &operator=(const SmallVector &other);
+    SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T> && kStealOnMove);
+
+    ~SmallVector();
+
+    T &operator[](size_t index) noexcept;
+    const T &operator[](size_t index) const noexcept;
+    T &at(size_t index);
+    const T &at(size_t index) const;
+    T &front();
+    const T &front() const;
+    T &back();
+    const T &back() const;
+    iterator erase(const_iterator pos);
+    void clear();
+
+    iterator erase_swap(const_iterator pos);
+    iterator remove_swap(const T &value);
+};
+
+template<typename T, size_t N, typename Allocator>
+T *SmallVector<T, N, Allocator>::inline_data() noexcept {
+    return reinterpret_cast<T *>(inline_);
+}
+
+template<typename T, size_t N, typename Allocator>
+bool SmallVector<T, N, Allocator>::is_inline() const noexcept {
+    return data_ == reinterpret_cast<const T *>(inline_);
+}
+
+template<typename T, size_t N, typename Allocator>
+size_t SmallVector<T, N, Allocator>::grow_capacity(const size_t min_capacity) const {
+    return std::max(capacity_ + capacity_ / 2, min_capacity);
+}
+
+// relocate - как в Vector: memcpy для тривиально копируемых типов, иначе перенос
+// элементов с откатом, если копирование бросает исключение
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::relocate(T *from, const size_t count, T *to) {
+    if constexpr (kTrivial) {
+        if (count != 0)
+            std::memcpy(static_cast<void *>(to), from, count * sizeof(T));
+    } else {
+        size_t built = 0;
+        try {
+            for (; built < count; ++built) {
+                alloc_traits::construct(alloc_, to + built, std::move_if_noexcept(from[built]));
+            }
+        } catch (...) {
+            for (size_t j = 0; j < built; ++j) {
+                alloc_traits::destroy(alloc_, to + j);
+            }
+            throw;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            alloc_traits::destroy(alloc_, from + i);
+        }
+    }
+}
+
+// reallocate переносит элементы в блок емкостью new_capacity; если элементы помещаются
+// во встроенный буфер, они возвращаются в него
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::reallocate(const size_t new_capacity) {
+    const bool to_inline = new_capacity <= N;
+    if (to_inline && is_inline())
+        return;
+
+    T *new_data = to_inline ? inline_data() : alloc_traits::allocate(alloc_, new_capacity);
+
+    try {
+        relocate(data_, size_, new_data);
+    } catch (...) {
+        if (!to_inline)
+            alloc_traits::deallocate(alloc_, new_data, new_capacity);
+        throw;
+    }
+
+    if (!is_inline())
+        alloc_traits::deallocate(alloc_, data_, capacity_);
+
+    data_ = new_data;
+    capacity_ = to_inline ? N : new_capacity;
+}
+
+// release разрушает элементы и отдает динамический блок, возвращаясь к встроенному буферу
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::release() noexcept {
+    clear();
+    if (!is_inline())
+        alloc_traits::deallocate(alloc_, data_, capacity_);
+
+    data_ = inline_data();
+    capacity_ = N;
+}
+
+// steal забирает содержимое other: динамический блок передается целиком,
+// элементы встроенного буфера переносятся по одному
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::steal(SmallVector &other) {
+    if (other.is_inline()) {
+        relocate(other.data_, other.size_, data_);
+        size_ = other.size_;
+    } else {
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inline_data();
+        other.capacity_ = N;
+    }
+    other.size_ = 0;
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector() : alloc_(), data_(inline_data()) {}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const Allocator &alloc) : alloc_(alloc), data_(inline_data()) {}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const SmallVector &other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)), data_(inline_data()) {
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        alloc_traits::construct(alloc_, data_ + i, other.data_[i]);
+        ++size_;
+    }
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : alloc_(std::move(other.alloc_)), data_(inline_data()) {
+    steal(other);
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const size_t size, const T &value) : alloc_(), data_(inline_data()) {
+    reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        alloc_traits::construct(alloc_, data_ + i, value);
+        ++size_;
+    }
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const size_t size) : alloc_(), data_(inline_data()) {
+    resize(size);
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::begin() noexcept {
+    return data_;
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::end() noexcept {
+    return data_ + size_;
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::const_iterator SmallVector<T, N, Allocator>::begin() const noexcept {
+    return data_;
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::const_iterator SmallVector<T, N, Allocator>::end() const noexcept {
+    return data_ + size_;
+}
+
+template<typename T, size_t N, typename Allocator>
+T *SmallVector<T, N, Allocator>::data() noexcept {
+    return data_;
+}
+
+template<typename T, size_t N, typename Allocator>
+const T *SmallVector<T, N, Allocator>::data() const noexcept {
+    return data_;
+}
+
+template<typename T, size_t N, typename Allocator>
+size_t SmallVector<T, N, Allocator>::size() const noexcept {
+    return size_;
+}
+
+template<typename T, size_t N, typename Allocator>
+size_t SmallVector<T, N, Allocator>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<typename T, size_t N, typename Allocator>
+bool SmallVector<T, N, Allocator>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::reserve(const size_t new_capacity) {
+    if (new_capacity <= capacity_)
+        return;
+
+    reallocate(new_capacity);
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::shrink_to_fit() {
+    if (!is_inline() && size_ < capacity_)
+        reallocate(size_);
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::resize(const size_t n) {
+    reserve(n);
+
+    for (size_t i = size_; i < n; ++i) {
+        alloc_traits::construct(alloc_, data_ + i);
+        ++size_;
+    }
+    for (size_t i = n; i < size_; ++i) {
+        alloc_traits::destroy(alloc_, data_ + i);
+    }
+
+    size_ = n;
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::push_back(const T &value) {
+    emplace_back(value);
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::push_back(T &&value) {
+    emplace_back(std::move(value));
+}
+
+template<typename T, size_t N, typename Allocator>
+template<typename... Args>
+T &SmallVector<T, N, Allocator>::emplace_back(Args &&... args) {
+    if (size_ == capacity_) {
+        // элемент строится до переноса: аргументы могут ссылаться на элементы вектора
+        T value(std::forward<Args>(args)...);
+        reallocate(grow_capacity(size_ + 1));
+        alloc_traits::construct(alloc_, data_ + size_, std::move(value));
+    } else {
+        alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+    }
+    return data_[size_++];
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::pop_back() noexcept {
+    if (size_ > 0) {
+        --size_;
+        alloc_traits::destroy(alloc_, data_ + size_);
+    }
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::del(const T &value) {
+    for (size_t i = 0; i < size_; ++i) {
+        if (data_[i] == value) {
+            return erase(data_ + i);
+        }
+    }
+    return end();
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::insert(const_iterator pos, const T &value) {
+    return emplace(pos, value);
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::insert(const_iterator pos, T &&value) {
+    return emplace(pos, std::move(value));
+}
+
+template<typename T, size_t N, typename Allocator>
+template<typename... Args>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::emplace(const_iterator pos, Args &&... args) {
+    const size_t index = pos - data_;
+    if (index == size_) {
+        emplace_back(std::forward<Args>(args)...);
+        return data_ + index;
+    }
+
+    T value(std::forward<Args>(args)...);
+
+    if (size_ == capacity_) {
+        reallocate(grow_capacity(size_ + 1));
+    }
+
+    if constexpr (kTrivial) {
+        std::memmove(static_cast<void *>(data_ + index + 1), data_ + index, (size_ - index) * sizeof(T));
+        alloc_traits::construct(alloc_, data_ + index, std::move(value));
+    } else {
+        alloc_traits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+        std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
+        data_[index] = std::move(value);
+    }
+
+    ++size_;
+    return data_ + index;
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator> &SmallVector<T, N, Allocator>::operator=(const SmallVector &other) {
+    if (this == &other)
+        return *this;
+
+    clear();
+    reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        alloc_traits::construct(alloc_, data_ + i, other.data_[i]);
+        ++size_;
+    }
+    return *this;
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator> &SmallVector<T, N, Allocator>::operator=(SmallVector &&other)
+    noexcept(std::is_nothrow_move_constructible_v<T> && kStealOnMove) {
+    if (this == &other)
+        return *this;
+
+    release();
+
+    // аллокаторы разные и не переносятся: элементы переезжают в нашу память по одному
+    if constexpr (!kStealOnMove) {
+        if (alloc_ != other.alloc_) {
+            reserve(other.size_);
+            relocate(other.data_, other.size_, data_);
+            size_ = other.size_;
+            other.size_ = 0;
+            other.release();
+            return *this;
+        }
+    }
+
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+    }
+    steal(other);
+    return *this;
+}
+
+template<typename T, size_t N, typename Allocator>
+SmallVector<T, N, Allocator>::~SmallVector() {
+    release();
+}
+
+template<typename T, size_t N, typename Allocator>
+T &SmallVector<T, N, Allocator>::operator[](const size_t index) noexcept {
+    return data_[index];
+}
+
+template<typename T, size_t N, typename Allocator>
+const T &SmallVector<T, N, Allocator>::operator[](const size_t index) const noexcept {
+    return data_[index];
+}
+
+template<typename T, size_t N, typename Allocator>
+T &SmallVector<T, N, Allocator>::at(const size_t index) {
+    if (index >= size_) {
+        throw std::out_of_range("index out of range");
+    }
+    return data_[index];
+}
+
+template<typename T, size_t N, typename Allocator>
+const T &SmallVector<T, N, Allocator>::at(const size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("index out of range");
+    }
+    return data_[index];
+}
+
+template<typename T, size_t N, typename Allocator>
+T &SmallVector<T, N, Allocator>::front() {
+    if (size_ == 0) throw std::out_of_range("Vector is empty");
+    return data_[0];
+}
+
+template<typename T, size_t N, typename Allocator>
+const T &SmallVector<T, N, Allocator>::front() const {
+    if (size_ == 0) throw std::out_of_range("Vector is empty");
+    return data_[0];
+}
+
+template<typename T, size_t N, typename Allocator>
+T &SmallVector<T, N, Allocator>::back() {
+    if (size_ == 0) throw std::out_of_range("Vector is empty");
+    return data_[size_ - 1];
+}
+
+template<typename T, size_t N, typename Allocator>
+const T &SmallVector<T, N, Allocator>::back() const {
+    if (size_ == 0) throw std::out_of_range("Vector is empty");
+    return data_[size_ - 1];
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::erase(const_iterator pos) {
+    const size_t index = pos - data_;
+
+    if constexpr (kTrivial) {
+        std::memmove(static_cast<void *>(data_ + index), data_ + index + 1, (size_ - index - 1) * sizeof(T));
+    } else {
+        std::move(data_ + index + 1, data_ + size_, data_ + index);
+        alloc_traits::destroy(alloc_, data_ + size_ - 1);
+    }
+
+    --size_;
+    return data_ + index;
+}
+
+template<typename T, size_t N, typename Allocator>
+void SmallVector<T, N, Allocator>::clear() {
+    for (size_t i = 0; i < size_; ++i) {
+        alloc_traits::destroy(alloc_, data_ + i);
+    }
+    size_ = 0;
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::erase_swap(const_iterator pos) {
+    const size_t index = pos - data_;
+    if (index >= size_) return end();
+
+    if (index != size_ - 1) {
+        data_[index] = std::move(data_[size_ - 1]);
+    }
+    alloc_traits::destroy(alloc_, data_ + size_ - 1);
+
+    --size_;
+    return (index < size_) ? data_ + index : end();
+}
+
+template<typename T, size_t N, typename Allocator>
+typename SmallVector<T, N, Allocator>::iterator SmallVector<T, N, Allocator>::remove_swap(const T &value) {
+    for (size_t i = 0; i < size_; ++i) {
+        if (data_[i] == value) {
+            return erase_swap(data_ + i);
+        }
+    }
+    return end();
+}
+
+#endif //SMALLVECTOR_H
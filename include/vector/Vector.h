@@ -5,7 +5,13 @@
 #ifndef VECTOR_H
 #define VECTOR_H
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 template<typename T, typename Allocator = std::allocator<T>>
 class [[maybe_unused]] Vector {
@@ -20,9 +26,25 @@ private:
     size_t size_ = 0;
     size_t capacity_ = 0;
 
+    // тривиально копируемые элементы (id, записи оценок) переносятся memcpy/memmove,
+    // остальные - перемещением, если оно не бросает, иначе копированием
+    static constexpr bool kTrivial = std::is_trivially_copyable_v<T>;
+    // блок другого вектора можно забрать при перемещении, только если освободить его
+    // сможет наш аллокатор
+    static constexpr bool kStealOnMove =
+            alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value;
+
+    [[nodiscard]] size_t grow_capacity(size_t min_capacity) const;
+    void relocate(T *from, size_t count, T *to);
+    void reallocate(size_t new_capacity);
+    template<typename... Args>
+    T &realloc_append(Args &&... args);
+
 public:
     Vector();
+    explicit Vector(const Allocator &alloc);
     Vector(const Vector &other);
+    Vector(Vector &&other) noexcept;
     Vector(size_t size, const T& value);
     explicit Vector(size_t size);
 
@@ -30,20 +52,28 @@ public:
     iterator end() noexcept;
     const_iterator begin() const noexcept;
     const_iterator end() const noexcept;
+    T *data() noexcept;
+    const T *data() const noexcept;
     [[nodiscard]] size_t size() const noexcept;
     [[nodiscard]] size_t capacity() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
-    void reserve(size_t new_capacity) noexcept;
+    void reserve(size_t new_capacity);
+    void shrink_to_fit();
     void resize(size_t n);
-    void push_back(const T &value) noexcept;
-    void push_back(T &&value) noexcept;
+    void push_back(const T &value);
+    void push_back(T &&value);
+    template<typename... Args>
+    T &emplace_back(Args &&... args);
     void pop_back() noexcept;
     iterator del(const T& value);
     iterator insert(const_iterator pos, const T &value);
+    iterator insert(const_iterator pos, T &&value);
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args &&... args);
 
     Vector &operator=(const Vector &other);
 
-    Vector &operator=(Vector &&other) noexcept;
+    Vector &operator=(Vector &&other) noexcept(kStealOnMove);
 
     ~Vector();
 
@@ -62,6 +92,10 @@ public:
     iterator remove_swap(const T &value);
 };
 
+// PmrVector выделяет память из переданного ресурса - например, из арены запроса (utils::Arena)
+template<typename T>
+using PmrVector = Vector<T, std::pmr::polymorphic_allocator<T>>;
+
 template<typename T, typename Allocator>
 void Vector<T, Allocator>::clear() {
     for (size_t i = 0; i < size_; ++i) {
@@ -75,12 +109,10 @@ typename Vector<T, Allocator>::iterator Vector<T, Allocator>::erase_swap(const_i
     size_t index = pos - data_;
     if (index >= size_) return end();
 
-    alloc_traits::destroy(alloc_, data_ + index);
-
     if (index != size_ - 1) {
-        alloc_traits::construct(alloc_, data_ + index, std::move(data_[size_ - 1]));
-        alloc_traits::destroy(alloc_, data_ + size_ - 1);
+        data_[index] = std::move(data_[size_ - 1]);
     }
+    alloc_traits::destroy(alloc_, data_ + size_ - 1);
 
     --size_;
     return (index < size_) ? data_ + index : end();
@@ -99,11 +131,12 @@ typename Vector<T, Allocator>::iterator Vector<T, Allocator>::remove_swap(const
 template<typename T, typename Allocator>
 typename Vector<T, Allocator>::iterator Vector<T, Allocator>::erase(const_iterator pos) {
     size_t index = pos - data_;
-    alloc_traits::destroy(alloc_, data_ + index);
 
-    for (size_t i = index; i < size_ - 1; ++i) {
-        alloc_traits::construct(alloc_, data_ + i, std::move(data_[i + 1]));
-        alloc_traits::destroy(alloc_, data_ + (i + 1));
+    if constexpr (kTrivial) {
+        std::memmove(static_cast<void *>(data_ + index), data_ + index + 1, (size_ - index - 1) * sizeof(T));
+    } else {
+        std::move(data_ + index + 1, data_ + size_, data_ + index);
+        alloc_traits::destroy(alloc_, data_ + size_ - 1);
     }
 
     --size_;
@@ -164,6 +197,10 @@ template<typename T, typename Allocator>
 Vector<T, Allocator>::Vector()
         : alloc_(), data_(nullptr), size_(0), capacity_(0) {}
 
+template<typename T, typename Allocator>
+Vector<T, Allocator>::Vector(const Allocator &alloc)
+        : alloc_(alloc), data_(nullptr), size_(0), capacity_(0) {}
+
 template<typename T, typename Allocator>
 Vector<T, Allocator>::Vector(const Vector &other) : alloc_(
         alloc_traits::select_on_container_copy_construction(other.alloc_)) {
@@ -174,6 +211,14 @@ Vector<T, Allocator>::Vector(const Vector &other) : alloc_(
     size_ = other.size_;
 }
 
+template<typename T, typename Allocator>
+Vector<T, Allocator>::Vector(Vector &&other) noexcept
+        : alloc_(std::move(other.alloc_)), data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
 template<typename T, typename Allocator>
 Vector<T, Allocator>::Vector(size_t size, const T& value)
         : alloc_(), data_(nullptr) {
@@ -223,6 +268,16 @@ typename Vector<T, Allocator>::const_iterator Vector<T, Allocator>::end() const
     return data_ + size_;
 }
 
+template<typename T, typename Allocator>
+T *Vector<T, Allocator>::data() noexcept {
+    return data_;
+}
+
+template<typename T, typename Allocator>
+const T *Vector<T, Allocator>::data() const noexcept {
+    return data_;
+}
+
 template<typename T, typename Allocator>
 size_t Vector<T, Allocator>::size() const noexcept {
     return size_;
@@ -238,29 +293,50 @@ bool Vector<T, Allocator>::empty() const noexcept {
     return size_ == 0;
 }
 
+// grow_capacity - новая емкость при росте: в полтора раза больше текущей, но не меньше
+// min_capacity и не меньше 4 элементов, чтобы маленькие векторы не перевыделялись на каждой
+// вставке. Множитель 1.5 позволяет аллокатору повторно использовать освобожденные блоки
 template<typename T, typename Allocator>
-void Vector<T, Allocator>::reserve(size_t new_capacity) noexcept {
-    if (new_capacity <= capacity_) {
-        return;
-    }
-
-    iterator new_data = alloc_traits::allocate(alloc_, new_capacity);
+size_t Vector<T, Allocator>::grow_capacity(const size_t min_capacity) const {
+    return std::max(capacity_ + capacity_ / 2, std::max(min_capacity, size_t{4}));
+}
 
-    for (size_t i = 0; i < size_; ++i) {
+// relocate переносит count элементов из from в неинициализированную память to и разрушает
+// исходные. Если копирование бросает исключение, уже созданные копии разрушаются,
+// а исходные элементы остаются нетронутыми
+template<typename T, typename Allocator>
+void Vector<T, Allocator>::relocate(T *from, const size_t count, T *to) {
+    if constexpr (kTrivial) {
+        if (count != 0)
+            std::memcpy(static_cast<void *>(to), from, count * sizeof(T));
+    } else {
+        size_t built = 0;
         try {
-            alloc_traits::construct(alloc_, new_data + i, std::move(data_[i]));
+            for (; built < count; ++built) {
+                alloc_traits::construct(alloc_, to + built, std::move_if_noexcept(from[built]));
+            }
         } catch (...) {
-            for (size_t j = 0; j < i; ++j) {
-                alloc_traits::destroy(alloc_, new_data + j);
+            for (size_t j = 0; j < built; ++j) {
+                alloc_traits::destroy(alloc_, to + j);
             }
-
-            alloc_traits::deallocate(alloc_, new_data, new_capacity);
             throw;
         }
+
+        for (size_t i = 0; i < count; ++i) {
+            alloc_traits::destroy(alloc_, from + i);
+        }
     }
+}
 
-    for (size_t i = 0; i < size_; ++i) {
-        alloc_traits::destroy(alloc_, data_ + i);
+template<typename T, typename Allocator>
+void Vector<T, Allocator>::reallocate(const size_t new_capacity) {
+    T *new_data = new_capacity == 0 ? nullptr : alloc_traits::allocate(alloc_, new_capacity);
+
+    try {
+        relocate(data_, size_, new_data);
+    } catch (...) {
+        alloc_traits::deallocate(alloc_, new_data, new_capacity);
+        throw;
     }
 
     if (data_) {
@@ -271,6 +347,55 @@ void Vector<T, Allocator>::reserve(size_t new_capacity) noexcept {
     capacity_ = new_capacity;
 }
 
+// realloc_append строит новый элемент в новом блоке до переноса старых: аргументы
+// могут ссылаться на элементы самого вектора, и они должны оставаться живыми
+template<typename T, typename Allocator>
+template<typename... Args>
+T &Vector<T, Allocator>::realloc_append(Args &&... args) {
+    const size_t new_capacity = grow_capacity(size_ + 1);
+    T *new_data = alloc_traits::allocate(alloc_, new_capacity);
+
+    try {
+        alloc_traits::construct(alloc_, new_data + size_, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc_traits::deallocate(alloc_, new_data, new_capacity);
+        throw;
+    }
+
+    try {
+        relocate(data_, size_, new_data);
+    } catch (...) {
+        alloc_traits::destroy(alloc_, new_data + size_);
+        alloc_traits::deallocate(alloc_, new_data, new_capacity);
+        throw;
+    }
+
+    if (data_) {
+        alloc_traits::deallocate(alloc_, data_, capacity_);
+    }
+
+    data_ = new_data;
+    capacity_ = new_capacity;
+    return data_[size_++];
+}
+
+template<typename T, typename Allocator>
+void Vector<T, Allocator>::reserve(const size_t new_capacity) {
+    if (new_capacity <= capacity_) {
+        return;
+    }
+
+    reallocate(new_capacity);
+}
+
+// shrink_to_fit отдает лишнюю емкость, например после загрузки справочника
+template<typename T, typename Allocator>
+void Vector<T, Allocator>::shrink_to_fit() {
+    if (size_ < capacity_) {
+        reallocate(size_);
+    }
+}
+
 template<typename T, typename Allocator>
 void Vector<T, Allocator>::resize(size_t n) {
     if (n > capacity_) {
@@ -291,21 +416,24 @@ void Vector<T, Allocator>::resize(size_t n) {
 }
 
 template<typename T, typename Allocator>
-void Vector<T, Allocator>::push_back(const T &value) noexcept {
-    if (size_ >= capacity_) {
-        reserve(capacity_ == 0 ? 1 : capacity_ * 2);
-    }
-    alloc_traits::construct(alloc_, data_ + size_, value);
-    ++size_;
+void Vector<T, Allocator>::push_back(const T &value) {
+    emplace_back(value);
+}
+
+template<typename T, typename Allocator>
+void Vector<T, Allocator>::push_back(T &&value) {
+    emplace_back(std::move(value));
 }
 
 template<typename T, typename Allocator>
-void Vector<T, Allocator>::push_back(T &&value) noexcept {
-    if (size_ >= capacity_) {
-        reserve(capacity_ == 0 ? 1 : capacity_ * 2);
+template<typename... Args>
+T &Vector<T, Allocator>::emplace_back(Args &&... args) {
+    if (size_ == capacity_) {
+        return realloc_append(std::forward<Args>(args)...);
     }
-    alloc_traits::construct(alloc_, data_ + size_, std::move(value));
-    ++size_;
+
+    alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+    return data_[size_++];
 }
 
 template<typename T, typename Allocator>
@@ -328,18 +456,40 @@ typename Vector<T, Allocator>::iterator Vector<T, Allocator>::del(const T &value
 
 template<typename T, typename Allocator>
 typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(const_iterator pos, const T &value) {
-    size_t index = pos - data_;
+    return emplace(pos, value);
+}
+
+template<typename T, typename Allocator>
+typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(const_iterator pos, T &&value) {
+    return emplace(pos, std::move(value));
+}
 
-    if (size_ >= capacity_) {
-        reserve(capacity_ == 0 ? 1 : capacity_ * 2);
+// emplace вставляет элемент перед pos. Элемент сначала строится отдельно, потому что
+// аргументы могут ссылаться на сдвигаемые элементы вектора
+template<typename T, typename Allocator>
+template<typename... Args>
+typename Vector<T, Allocator>::iterator Vector<T, Allocator>::emplace(const_iterator pos, Args &&... args) {
+    const size_t index = pos - data_;
+    if (index == size_) {
+        emplace_back(std::forward<Args>(args)...);
+        return data_ + index;
     }
 
-    for (size_t i = size_; i > index; --i) {
-        alloc_traits::construct(alloc_, data_ + i, std::move(data_[i - 1]));
-        alloc_traits::destroy(alloc_, data_ + (i - 1));
+    T value(std::forward<Args>(args)...);
+
+    if (size_ == capacity_) {
+        reserve(grow_capacity(size_ + 1));
+    }
+
+    if constexpr (kTrivial) {
+        std::memmove(static_cast<void *>(data_ + index + 1), data_ + index, (size_ - index) * sizeof(T));
+        alloc_traits::construct(alloc_, data_ + index, std::move(value));
+    } else {
+        alloc_traits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+        std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
+        data_[index] = std::move(value);
     }
 
-    alloc_traits::construct(alloc_, data_ + index, value);
     ++size_;
     return data_ + index;
 }
@@ -368,16 +518,33 @@ Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector& other) {
 }
 
 template<typename T, typename Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector&& other) noexcept {
+Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector&& other) noexcept(kStealOnMove) {
     if (this == &other)
         return *this;
 
     clear();
 
+    // аллокаторы разные и не переносятся (например, арены разных запросов):
+    // блок other забрать нельзя, элементы переносятся в нашу память по одному
+    if constexpr (!kStealOnMove) {
+        if (alloc_ != other.alloc_) {
+            reserve(other.size_);
+            for (size_t i = 0; i < other.size_; ++i) {
+                alloc_traits::construct(alloc_, data_ + i, std::move(other.data_[i]));
+                ++size_;
+            }
+            other.clear();
+            return *this;
+        }
+    }
+
     if (data_) {
         alloc_traits::deallocate(alloc_, data_, capacity_);
     }
 
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+    }
     data_ = other.data_;
     size_ = other.size_;
     capacity_ = other.capacity_;
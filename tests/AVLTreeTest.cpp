@@ -0,0 +1,126 @@
+#include <map>
+#include <random>
+#include <utility>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "Slog.h"
+#include "avl-tree/AVLTree.h"
+#include "model/Date.h"
+#include "model/GradeStats.h"
+
+using model::GradeStats;
+
+namespace {
+    // Reference - те же оценки в std::multimap: ключ -> (id, оценка)
+    using Reference = std::multimap<int, std::pair<int, int>>;
+
+    // fill вставляет и удаляет случайные оценки, поддерживая дерево и эталон одинаковыми
+    void fill(AVLTree<int, GradeStats> &tree, Reference &reference, const int operations, const int keys) {
+        std::mt19937 gen(5);
+        for (int id = 0; id < operations; ++id) {
+            const int key = static_cast<int>(gen() % keys);
+            const int grade = static_cast<int>(gen() % 5 + 1);
+            if (gen() % 3 != 0) {
+                tree.insert(key, id, GradeStats::of(grade));
+                reference.insert({key, {id, grade}});
+            } else if (const auto it = reference.find(key); it != reference.end()) {
+                tree.del(key, it->second.first, GradeStats::of(it->second.second));
+                reference.erase(it);
+            }
+        }
+    }
+
+    GradeStats expected_stats(const Reference &reference, const int low, const int high) {
+        GradeStats stats;
+        for (const auto &[key, value]: reference) {
+            if (key >= low && key <= high) stats += GradeStats::of(value.second);
+        }
+        return stats;
+    }
+
+    size_t expected_count(const Reference &reference, const int low, const int high) {
+        std::map<int, int> distinct;
+        for (const auto &[key, value]: reference) {
+            if (key >= low && key <= high) distinct[key] = 1;
+        }
+        return distinct.size();
+    }
+}
+
+TEST_CASE("range_aggregate совпадает с перебором", "[avl][stats]") {
+    AVLTree<int, GradeStats> tree;
+    Reference reference;
+    fill(tree, reference, 4000, 300);
+
+    std::mt19937 gen(9);
+    for (int i = 0; i < 500; ++i) {
+        // границы выходят за диапазон ключей и иногда идут в обратном порядке
+        const int low = static_cast<int>(gen() % 320) - 10;
+        const int high = static_cast<int>(gen() % 320) - 10;
+        REQUIRE(tree.range_aggregate(low, high) == expected_stats(reference, low, high));
+        REQUIRE(tree.count_in_range(low, high) == expected_count(reference, low, high));
+    }
+
+    REQUIRE(tree.aggregate() == expected_stats(reference, 0, 300));
+}
+
+TEST_CASE("Границы отрезка включаются", "[avl][stats]") {
+    AVLTree<int, GradeStats> tree;
+    for (int key = 0; key < 100; ++key) {
+        tree.insert(key, key, GradeStats::of(key % 5 + 1));
+        tree.insert(key, 100 + key, GradeStats::of(5));
+    }
+
+    for (int key = 0; key < 100; ++key) {
+        const auto stats = tree.range_aggregate(key, key);
+        REQUIRE(stats.count() == 2);
+        REQUIRE(stats.count(5) == (key % 5 == 4 ? 2u : 1u));
+        REQUIRE(tree.count_in_range(key, key) == 1);
+    }
+
+    REQUIRE(tree.range_aggregate(10, 19).count() == 20);
+    REQUIRE(tree.range_aggregate(19, 10).count() == 0);
+    REQUIRE(tree.range_aggregate(100, 200).count() == 0);
+    REQUIRE(tree.range_aggregate(-5, -1).count() == 0);
+}
+
+TEST_CASE("Статистика после build_sorted и после вставок совпадает", "[avl][stats]") {
+    constexpr int kCount = 3000;
+    std::mt19937 gen(3);
+    Vector<int> keys(kCount), grades(kCount);
+    for (int i = 0; i < kCount; ++i) {
+        keys[i] = static_cast<int>(gen() % 500);
+        grades[i] = static_cast<int>(gen() % 5 + 1);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    AVLTree<int, GradeStats> built, inserted;
+    built.build_sorted(kCount, [&](const size_t id) { return keys[id]; },
+                       [&](const size_t id) { return GradeStats::of(grades[id]); });
+    for (int id = 0; id < kCount; ++id) {
+        inserted.insert(keys[id], id, GradeStats::of(grades[id]));
+    }
+
+    for (int low = -1; low < 510; low += 17) {
+        REQUIRE(built.range_aggregate(low, low + 40) == inserted.range_aggregate(low, low + 40));
+    }
+    REQUIRE(built.aggregate() == inserted.aggregate());
+}
+
+TEST_CASE("Статистика по датам", "[avl][stats]") {
+    AVLTree<model::Date, GradeStats> tree;
+    tree.insert(model::Date::parse("01 sep 2024"), 0, GradeStats::of(5));
+    tree.insert(model::Date::parse("15 sep 2024"), 1, GradeStats::of(3));
+    tree.insert(model::Date::parse("15 sep 2024"), 2, GradeStats::of(4));
+    tree.insert(model::Date::parse("01 oct 2024"), 3, GradeStats::of(2));
+
+    const auto september = tree.range_aggregate(model::Date::parse("01 sep 2024"), model::Date::parse("30 sep 2024"));
+    REQUIRE(september.count() == 3);
+    REQUIRE(september.sum() == 12);
+    REQUIRE(september.average() == Catch::Approx(4.0));
+
+    tree.del(model::Date::parse("15 sep 2024"), 1, GradeStats::of(3));
+    REQUIRE(tree.range_aggregate(model::Date::parse("15 sep 2024"), model::Date::parse("15 sep 2024")).count() == 1);
+    REQUIRE(tree.aggregate().count() == 3);
+}
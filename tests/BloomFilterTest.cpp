@@ -0,0 +1,106 @@
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "hash/BloomFilter.h"
+
+namespace {
+    std::string key_of(const size_t n) {
+        return "Иванов Артем Сергеевич " + std::to_string(n);
+    }
+
+    // rebuild повторяет StudentRepo::rebuild_bloom: фильтр с запасом вдвое под текущие ключи
+    void rebuild(hash::BloomFilter<std::string> &filter, const std::unordered_set<std::string> &live) {
+        filter.reset(live.size() * 2);
+        for (const auto &key: live) {
+            filter.insert(key);
+        }
+    }
+}
+
+TEST_CASE("needs_rebuild срабатывает при переполнении и при удалениях", "[bloom]") {
+    hash::BloomFilter<std::string> filter(100);
+    for (size_t i = 0; i < 100; ++i) {
+        filter.insert(key_of(i));
+    }
+    REQUIRE_FALSE(filter.needs_rebuild());
+
+    SECTION("вставки сверх расчетного размера") {
+        filter.insert(key_of(100));
+        REQUIRE(filter.needs_rebuild());
+    }
+    SECTION("удалена четверть ключей") {
+        for (size_t i = 0; i < 25; ++i) filter.erase();
+        REQUIRE_FALSE(filter.needs_rebuild());
+        filter.erase();
+        REQUIRE(filter.needs_rebuild());
+        REQUIRE(filter.size() == 74);
+    }
+}
+
+TEST_CASE("Фильтр не теряет ключи при вставках, удалениях и перестройках", "[bloom]") {
+    std::mt19937 gen(27);
+    std::unordered_set<std::string> live;
+    hash::BloomFilter<std::string> filter;
+    rebuild(filter, live);
+
+    size_t next = 0;
+    size_t grow_rebuilds = 0;
+    size_t erase_rebuilds = 0;
+    size_t missed = 0;
+    for (size_t step = 0; step < 20000; ++step) {
+        // сначала ключи в основном добавляются, потом в основном удаляются: фильтр
+        // перестраивается и от роста, и от удалений
+        const bool inserting = live.empty() || gen() % 4 < (step < 10000 ? 3u : 1u);
+        if (inserting) {
+            auto key = key_of(next++);
+            filter.insert(key);
+            live.insert(std::move(key));
+        } else {
+            live.erase(live.begin());
+            filter.erase();
+        }
+        if (filter.needs_rebuild()) {
+            rebuild(filter, live);
+            ++(inserting ? grow_rebuilds : erase_rebuilds);
+        }
+
+        if (step % 500 == 0) {
+            for (const auto &key: live) {
+                missed += !filter.may_contain(key);
+            }
+        }
+    }
+    for (const auto &key: live) {
+        missed += !filter.may_contain(key);
+    }
+
+    REQUIRE(grow_rebuilds > 0);
+    REQUIRE(erase_rebuilds > 0);
+    REQUIRE(missed == 0);
+}
+
+TEST_CASE("Доля ложных срабатываний заполненного фильтра ограничена", "[bloom]") {
+    constexpr size_t kKeys = 20000;
+    constexpr size_t kProbes = 200000;
+
+    hash::BloomFilter<std::string> filter(kKeys);
+    for (size_t i = 0; i < kKeys; ++i) {
+        filter.insert(key_of(i));
+    }
+    REQUIRE_FALSE(filter.needs_rebuild());
+
+    size_t false_positives = 0;
+    for (size_t i = kKeys; i < kKeys + kProbes; ++i) {
+        false_positives += filter.may_contain(key_of(i));
+    }
+
+    // 12 бит фильтра на ключ и 8 битов ключа в одном блоке дают меньше 1% при расчетном
+    // заполнении; 2% - запас на неравномерное заполнение блоков
+    const double rate = static_cast<double>(false_positives) / kProbes;
+    INFO("доля ложных срабатываний: " << rate);
+    REQUIRE(rate < 0.02);
+}
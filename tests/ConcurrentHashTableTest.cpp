@@ -0,0 +1,159 @@
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "hash/ConcurrentHashTable.h"
+
+namespace {
+    std::vector<std::string> make_keys(const size_t count) {
+        std::vector<std::string> keys;
+        keys.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            keys.push_back("k" + std::to_string(i));
+        }
+        return keys;
+    }
+
+    // run_readers делит lookups поисков поровну между threads потоками и ждет их завершения
+    template<typename Find>
+    size_t run_readers(const size_t threads, const size_t lookups, const std::vector<std::string> &keys, Find &&find) {
+        std::atomic<size_t> found{0};
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                size_t local = 0;
+                for (size_t i = t; i < lookups; i += threads) {
+                    local += find(keys[i * 7919 % keys.size()]);
+                }
+                found += local;
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        return found;
+    }
+}
+
+TEST_CASE("Читатели видят только целые значения, пока писатель меняет таблицу", "[concurrent]") {
+    constexpr long kKeys = 1000;
+    const auto keys = make_keys(kKeys);
+
+    hash::ConcurrentHashTable<std::string, long> table;
+    for (long i = 0; i < kKeys; ++i) {
+        table.insert(keys[i], i);
+    }
+
+    constexpr int kReaders = 4;
+    std::atomic<bool> stop{false};
+    std::atomic<int> started{0};
+    std::atomic<long> bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&] {
+            ++started;
+            while (!stop) {
+                for (long i = 0; i < kKeys; ++i) {
+                    const auto value = table.get(keys[i]);
+                    if (!value || *value % 1000000 != i) ++bad;
+                }
+            }
+        });
+    }
+    while (started < kReaders) {
+        std::this_thread::yield();
+    }
+
+    // обновления, вставки и удаления посторонних ключей заставляют таблицу расширяться
+    for (long round = 0; round < 10; ++round) {
+        for (long i = 0; i < kKeys; ++i) {
+            table.update(keys[i], round * 1000000 + i);
+        }
+        for (long i = 0; i < 500; ++i) {
+            table.insert("x" + std::to_string(round * 1000 + i), 1);
+        }
+        for (long i = 0; i < 500; ++i) {
+            table.erase("x" + std::to_string(round * 1000 + i));
+        }
+    }
+    stop = true;
+    for (auto &reader: readers) {
+        reader.join();
+    }
+
+    REQUIRE(bad == 0);
+    REQUIRE(table.size() == kKeys);
+}
+
+TEST_CASE("Одновременные вставки из нескольких потоков расширяют таблицу", "[concurrent]") {
+    constexpr size_t kWriters = 8;
+    constexpr size_t kKeys = 20000;
+    const auto keys = make_keys(kKeys);
+
+    // начальная ёмкость 16: за время теста таблица расширяется много раз, пока другие
+    // писатели вставляют в нее
+    hash::ConcurrentHashTable<std::string, size_t> table;
+    std::atomic<size_t> inserted{0};
+    std::atomic<size_t> failed{0};
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < kWriters; ++t) {
+        writers.emplace_back([&, t] {
+            try {
+                // каждый ключ пишут два потока - вставиться должен ровно один раз
+                for (size_t i = t / 2; i < kKeys; i += kWriters / 2) {
+                    inserted += table.insert(keys[i], i);
+                }
+            } catch (const std::overflow_error &) {
+                ++failed;
+            }
+        });
+    }
+    for (auto &writer: writers) {
+        writer.join();
+    }
+
+    REQUIRE(failed == 0);
+    REQUIRE(inserted == kKeys);
+    REQUIRE(table.size() == kKeys);
+    REQUIRE(table.capacity() * 2 >= kKeys * 3);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < kKeys; ++i) {
+        wrong += table.get(keys[i]) != i;
+    }
+    REQUIRE(wrong == 0);
+}
+
+TEST_CASE("Масштабирование чтения по потокам", "[concurrent][benchmark]") {
+    constexpr size_t kKeys = 1 << 16;
+    constexpr size_t kLookups = 1 << 18;
+    const auto keys = make_keys(kKeys);
+
+    hash::ConcurrentHashTable<std::string, size_t> table;
+    std::mutex mutex;
+    for (size_t i = 0; i < kKeys; ++i) {
+        table.insert(keys[i], i);
+    }
+
+    // одинаковый объем работы делится между потоками: чтение без блокировок должно
+    // ускоряться с ростом числа потоков, а то же чтение под общим mutex - нет
+    for (const size_t threads: {1, 2, 4, 8}) {
+        BENCHMARK("ConcurrentHashTable, потоков: " + std::to_string(threads)) {
+            return run_readers(threads, kLookups, keys, [&](const std::string &key) {
+                return table.contains(key);
+            });
+        };
+
+        BENCHMARK("Под общим mutex, потоков: " + std::to_string(threads)) {
+            return run_readers(threads, kLookups, keys, [&](const std::string &key) {
+                std::lock_guard lock(mutex);
+                return table.contains(key);
+            });
+        };
+    }
+}
@@ -0,0 +1,47 @@
+#include <stdexcept>
+#include <string>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "model/Date.h"
+
+using model::Date;
+using model::Month;
+
+TEST_CASE("Дата по умолчанию выводится как 00 jan 0", "[date]") {
+    const Date date;
+    REQUIRE(date.to_string() == "00 jan 0");
+    REQUIRE(date.month() == Month::Jan);
+    REQUIRE(!date);
+    REQUIRE(date < Date::parse("01 jan 1"));
+}
+
+TEST_CASE("parse принимает то же, что и прежний разбор", "[date]") {
+    REQUIRE(Date::parse("15 mar 2016") == Date(15, Month::Mar, 2016));
+    REQUIRE(Date::parse("  5   MAR 2016 ") == Date(5, Month::Mar, 2016));
+    REQUIRE(Date::parse("01 Dec 2025").to_string() == "01 dec 2025");
+
+    // день проверяется только на 1-31, без учета длины месяца
+    REQUIRE(Date::parse("30 feb 2020").to_string() == "30 feb 2020");
+    REQUIRE(Date::parse("31 apr 2021").to_string() == "31 apr 2021");
+}
+
+TEST_CASE("parse отвергает некорректные даты", "[date]") {
+    REQUIRE_THROWS_AS(Date::parse(""), std::invalid_argument);
+    REQUIRE_THROWS_AS(Date::parse("00 jan 2020"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Date::parse("32 jan 2020"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Date::parse("123 jan 2020"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Date::parse("10 foo 2020"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Date::parse("10 jan 2026"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Date::parse("10 jan"), std::invalid_argument);
+}
+
+TEST_CASE("Порядок дат совпадает с порядком упакованных значений", "[date]") {
+    const Date a = Date::parse("31 dec 2019"), b = Date::parse("01 jan 2020"), c = Date::parse("02 jan 2020");
+    REQUIRE(a < b);
+    REQUIRE(b < c);
+    REQUIRE(a.pack() < b.pack());
+    REQUIRE(Date::unpack(b.pack()) == b);
+    REQUIRE(Date::from_days(b.to_days()) == b);
+    REQUIRE(c.to_days() - a.to_days() == 2);
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "repository/GradeRepo.h"
+
+namespace {
+    std::string to_key(const model::PersonName &pn, const std::string &birth_date) {
+        return pn.to_string() + " " + birth_date;
+    }
+
+    std::pair<std::string, std::uint32_t> sort_key(const model::Grade &grade) {
+        return {to_key(grade.get_student_name(), grade.get_student_birth_date().to_string()), grade.get_date().pack()};
+    }
+
+    std::vector<model::Grade> random_grades(const size_t count) {
+        const char *names[] = {"Иванов Артем Сергеевич", "Петрова Софья Максимовна", "Сидоров Михаил Иванович",
+                               "Кузнецова Анна Павловна", "Орлов Денис Олегович"};
+        const char *months[] = {"jan", "feb", "mar", "apr", "may", "sep", "oct", "nov", "dec"};
+        const char *subjects[] = {"Математика", "Физика", "Русский язык"};
+
+        std::mt19937 gen(5);
+        std::vector<model::Grade> grades;
+        for (size_t i = 0; i < count; ++i) {
+            const auto date = std::to_string(gen() % 28 + 1) + " " + months[gen() % 9] + " 2025";
+            grades.emplace_back(model::PersonName::parse(names[gen() % 5]), model::Date::parse("15 mar 2016"),
+                                subjects[gen() % 3], static_cast<int>(gen() % 4 + 2), model::Date::parse(date));
+        }
+        return grades;
+    }
+
+    std::vector<std::string> read_lines(const std::string &path) {
+        std::ifstream in(path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty()) lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+TEST_CASE("sort_file совпадает со стабильной сортировкой в памяти", "[external-sort]") {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto src = (dir / "external_sort_src.txt").string();
+    const auto dst = (dir / "external_sort_dst.txt").string();
+
+    auto grades = random_grades(2000);
+    {
+        std::ofstream out(src);
+        for (const auto &grade: grades) {
+            out << grade.to_string() << '\n';
+        }
+    }
+
+    std::ranges::stable_sort(grades, {}, sort_key);
+    std::vector<std::string> expected;
+    for (const auto &grade: grades) {
+        expected.push_back(grade.to_string());
+    }
+
+    // маленький бюджет дает много отрезков и проверяет слияние, большой - один отрезок
+    const size_t budget = GENERATE(1 << 10, 1 << 14, 1 << 26);
+    const auto stats = repo::GradeRepo::sort_file(src, dst, to_key, budget);
+
+    REQUIRE(stats.items == grades.size());
+    if (budget == 1 << 26) REQUIRE(stats.runs == 1);
+    else REQUIRE(stats.runs > 1);
+    REQUIRE(read_lines(dst) == expected);
+
+    std::filesystem::remove(src);
+    std::filesystem::remove(dst);
+}
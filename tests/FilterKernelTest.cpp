@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <random>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "repository/FilterKernel.h"
+#include "vector/Vector.h"
+
+using namespace repo::kernel;
+
+namespace {
+    // Columns - случайные упакованные столбцы оценок (см. Date::pack)
+    struct Columns {
+        Vector<std::uint32_t> dates, births;
+        Vector<std::uint16_t> subjects;
+
+        explicit Columns(const size_t rows) : dates(rows), births(rows), subjects(rows) {
+            std::mt19937 gen(42);
+            for (size_t i = 0; i < rows; ++i) {
+                dates[i] = 2024u << 9 | (gen() % 12 + 1) << 5 | (gen() % 28 + 1);
+                births[i] = 2009u << 9 | (gen() % 2 + 1) << 5 | (gen() % 2 + 1);
+                subjects[i] = static_cast<std::uint16_t>(gen() % 4);
+            }
+        }
+
+        static GradePredicate predicate() {
+            return {2024u << 9 | 3 << 5 | 1, 2024u << 9 | 9 << 5 | 1, 2009u << 9 | 1 << 5 | 1, 0};
+        }
+    };
+}
+
+TEST_CASE("select совпадает со скалярной версией", "[filter]") {
+    // некратное 8 число строк проверяет и хвост векторной версии
+    const size_t rows = GENERATE(0, 7, 8, 1001, 1 << 14);
+    const Columns c(rows);
+    const auto p = c.predicate();
+
+    Vector<std::uint32_t> expected(rows), actual(rows);
+    const size_t count = select_scalar(c.dates.begin(), c.subjects.begin(), c.births.begin(), 0, rows, p,
+                                       expected.begin());
+    REQUIRE(select(c.dates.begin(), c.subjects.begin(), c.births.begin(), 0, rows, p, actual.begin()) == count);
+
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(actual[i] == expected[i]);
+    }
+
+#if defined(FILTER_KERNEL_HAS_AVX2)
+    if (cpu_has_avx2()) {
+        REQUIRE(select_avx2(c.dates.begin(), c.subjects.begin(), c.births.begin(), 0, rows, p, actual.begin()) ==
+                count);
+        for (size_t i = 0; i < count; ++i) {
+            REQUIRE(actual[i] == expected[i]);
+        }
+    }
+#endif
+}
+
+TEST_CASE("select учитывает границы диапазона строк", "[filter]") {
+    const Columns c(1000);
+    const auto p = c.predicate();
+
+    Vector<std::uint32_t> out(1000);
+    const size_t count = select(c.dates.begin(), c.subjects.begin(), c.births.begin(), 13, 977, p, out.begin());
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(out[i] >= 13);
+        REQUIRE(out[i] < 977);
+    }
+}
+
+TEST_CASE("Пропускная способность select", "[filter][benchmark]") {
+    constexpr size_t rows = 1 << 20;
+    const Columns c(rows);
+    const auto p = c.predicate();
+    Vector<std::uint32_t> out(rows);
+
+    BENCHMARK("select_scalar") {
+        return select_scalar(c.dates.begin(), c.subjects.begin(), c.births.begin(), 0, rows, p, out.begin());
+    };
+
+#if defined(FILTER_KERNEL_HAS_AVX2)
+    if (cpu_has_avx2()) {
+        BENCHMARK("select_avx2") {
+            return select_avx2(c.dates.begin(), c.subjects.begin(), c.births.begin(), 0, rows, p, out.begin());
+        };
+    }
+#endif
+}
@@ -0,0 +1,92 @@
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "hash/HashTable.h"
+
+namespace {
+    template<typename Key>
+    using Entries = std::vector<const typename hash::HashTable<Key, size_t>::EntryType *>;
+}
+
+TEST_CASE("search_many находит те же ячейки, что и search", "[hash]") {
+    std::mt19937 gen(1);
+    hash::HashTable<std::string, size_t> table(700);
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 600; ++i) {
+        keys.push_back("k" + std::to_string(gen() % 100000));
+        if (table.search(keys.back(), [] {}) == nullptr) table.append(keys.back(), i);
+    }
+    // удаленные ячейки пакетный поиск должен проходить, а не останавливаться на них
+    for (size_t i = 0; i < 100; ++i) {
+        table.del(keys[gen() % 600]);
+    }
+    for (size_t i = 0; i < 200; ++i) {
+        keys.push_back("m" + std::to_string(i));
+    }
+
+    Entries<std::string> out(keys.size());
+    table.search_many(std::span<const std::string>(keys), std::span(out), [] {});
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(out[i] == table.search(keys[i], [] {}));
+    }
+
+    // ключи можно передавать указателями
+    std::vector<const std::string *> refs;
+    for (const auto &key: keys) {
+        refs.push_back(&key);
+    }
+    Entries<std::string> by_ref(keys.size());
+    table.search_many(std::span<const std::string *const>(refs), std::span(by_ref), [] {});
+    REQUIRE(by_ref == out);
+}
+
+TEST_CASE("search_many на пустой таблице ничего не находит", "[hash]") {
+    const hash::HashTable<std::string, size_t> table;
+    const std::vector<std::string> keys{"a", "b", "c"};
+
+    Entries<std::string> out(keys.size(), nullptr);
+    table.search_many(std::span<const std::string>(keys), std::span(out), [] {});
+    for (const auto *entry: out) {
+        REQUIRE(entry == nullptr);
+    }
+}
+
+TEST_CASE("search_many против поиска по одному ключу", "[hash][benchmark]") {
+    // таблица больше кеша последнего уровня, чтобы поиск упирался в промахи
+    constexpr size_t capacity = 1 << 21;
+    constexpr size_t count = capacity * 2 / 3;
+    constexpr size_t lookups = 1 << 16;
+
+    std::mt19937_64 gen(7);
+    hash::HashTable<size_t, size_t> table(capacity);
+    std::vector<size_t> stored;
+    stored.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        stored.push_back(gen());
+        table.append(stored.back(), i);
+    }
+
+    std::vector<size_t> keys(lookups);
+    for (auto &key: keys) {
+        key = stored[gen() % count];
+    }
+    Entries<size_t> out(lookups);
+
+    BENCHMARK("search по одному ключу") {
+        size_t found = 0;
+        for (const size_t key: keys) {
+            found += table.search(key, [] {}) != nullptr;
+        }
+        return found;
+    };
+
+    BENCHMARK("search_many") {
+        table.search_many(std::span<const size_t>(keys), std::span(out), [] {});
+        return out.back();
+    };
+}
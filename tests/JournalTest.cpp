@@ -0,0 +1,163 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "repository/Journal.h"
+
+namespace {
+    using Frame = std::pair<repo::JournalOp, std::string>;
+
+    struct Paths {
+        std::string journal;
+        std::string students;
+        std::string grades;
+
+        explicit Paths(const std::string &name) {
+            const auto dir = std::filesystem::temp_directory_path();
+            students = (dir / (name + "_students.txt")).string();
+            grades = (dir / (name + "_grades.txt")).string();
+            journal = repo::Journal::path_for(grades);
+            clear();
+        }
+
+        ~Paths() { clear(); }
+
+        void clear() const {
+            for (const auto &path: {journal, journal + ".tmp", journal + ".foreign"})
+                std::filesystem::remove(path);
+        }
+    };
+
+    std::vector<Frame> replay(const Paths &paths, const std::string &students) {
+        std::vector<Frame> frames;
+        repo::Journal::replay(paths.journal, students, paths.grades,
+                              [&frames](const repo::JournalOp op, const std::string &record) {
+                                  frames.emplace_back(op, record);
+                              });
+        return frames;
+    }
+
+    std::vector<Frame> replay(const Paths &paths) {
+        return replay(paths, paths.students);
+    }
+
+    std::vector<Frame> sample_frames(const size_t count) {
+        const repo::JournalOp ops[] = {repo::JournalOp::AddStudent, repo::JournalOp::DelStudent,
+                                       repo::JournalOp::AddGrade, repo::JournalOp::DelGrade};
+        std::vector<Frame> frames;
+        for (size_t i = 0; i < count; ++i) {
+            frames.emplace_back(ops[i % 4], "Иванов Артем Сергеевич 15 mar 2016 запись " + std::to_string(i));
+        }
+        return frames;
+    }
+}
+
+TEST_CASE("Журнал возвращает зафиксированные кадры в порядке записи", "[journal]") {
+    const Paths paths("journal_round_trip");
+    const auto frames = sample_frames(300);
+    {
+        repo::Journal journal(paths.journal, paths.students, paths.grades);
+        for (size_t i = 0; i < frames.size(); ++i) {
+            journal.append(frames[i].first, frames[i].second);
+            if (i % 100 == 99) journal.commit();
+        }
+        REQUIRE(journal.pending() == 0);
+    }
+    REQUIRE(replay(paths) == frames);
+
+    // повторное открытие дописывает после уже записанных кадров, не повторяя заголовок
+    {
+        repo::Journal journal(paths.journal, paths.students, paths.grades);
+        journal.append(repo::JournalOp::DelGrade, "последняя");
+        journal.commit();
+    }
+    auto expected = frames;
+    expected.emplace_back(repo::JournalOp::DelGrade, "последняя");
+    REQUIRE(replay(paths) == expected);
+}
+
+TEST_CASE("Оборванный хвост журнала отбрасывается и отрезается от файла", "[journal]") {
+    const Paths paths("journal_torn_tail");
+    const auto frames = sample_frames(10);
+    std::uint64_t valid;
+    {
+        repo::Journal journal(paths.journal, paths.students, paths.grades);
+        for (const auto &[op, record]: frames) journal.append(op, record);
+        journal.commit();
+        valid = journal.size();
+    }
+
+    // начало следующего кадра без конца и контрольной суммы
+    const auto torn = GENERATE(1, 5, 20);
+    {
+        repo::Journal journal(paths.journal, paths.students, paths.grades);
+        journal.append(repo::JournalOp::AddGrade, "оборванная запись, которой нет в файле целиком");
+        journal.commit();
+    }
+    std::filesystem::resize_file(paths.journal, valid + torn);
+
+    REQUIRE(replay(paths) == frames);
+    REQUIRE(std::filesystem::file_size(paths.journal) == valid);
+
+    // после обрезки журнал снова дописывается и читается целиком
+    {
+        repo::Journal journal(paths.journal, paths.students, paths.grades);
+        journal.append(repo::JournalOp::DelStudent, "после обрыва");
+        journal.commit();
+    }
+    auto expected = frames;
+    expected.emplace_back(repo::JournalOp::DelStudent, "после обрыва");
+    REQUIRE(replay(paths) == expected);
+}
+
+TEST_CASE("Журнал других справочников не применяется и откладывается", "[journal]") {
+    const Paths paths("journal_foreign");
+    {
+        repo::Journal journal(paths.journal, paths.students, paths.grades);
+        journal.append(repo::JournalOp::AddStudent, "чужая запись");
+        journal.commit();
+    }
+    const auto size = std::filesystem::file_size(paths.journal);
+
+    const auto other_students = paths.students + ".other";
+    REQUIRE(replay(paths, other_students).empty());
+    REQUIRE_FALSE(std::filesystem::exists(paths.journal));
+    REQUIRE(std::filesystem::file_size(paths.journal + ".foreign") == size);
+
+    // новый журнал для другой пары начинается с чистого заголовка
+    {
+        repo::Journal journal(paths.journal, other_students, paths.grades);
+        journal.append(repo::JournalOp::AddStudent, "своя запись");
+        journal.commit();
+    }
+    REQUIRE(replay(paths, other_students) == std::vector<Frame>{{repo::JournalOp::AddStudent, "своя запись"}});
+}
+
+TEST_CASE("drop_prefix сохраняет кадры, записанные во время переноса", "[journal]") {
+    const Paths paths("journal_drop_prefix");
+    const auto frames = sample_frames(40);
+
+    repo::Journal journal(paths.journal, paths.students, paths.grades);
+    for (size_t i = 0; i < 20; ++i) journal.append(frames[i].first, frames[i].second);
+    journal.commit();
+    const auto mark = journal.size();
+
+    // перенос идет в фоне: часть изменений уже зафиксирована, часть еще в очереди
+    for (size_t i = 20; i < 30; ++i) journal.append(frames[i].first, frames[i].second);
+    journal.commit();
+    for (size_t i = 30; i < 35; ++i) journal.append(frames[i].first, frames[i].second);
+
+    journal.drop_prefix(mark);
+    REQUIRE(replay(paths) == std::vector(frames.begin() + 20, frames.begin() + 30));
+    REQUIRE(journal.size() == std::filesystem::file_size(paths.journal));
+    REQUIRE(journal.pending() == 5);
+
+    for (size_t i = 35; i < 40; ++i) journal.append(frames[i].first, frames[i].second);
+    journal.commit();
+    REQUIRE(replay(paths) == std::vector(frames.begin() + 20, frames.end()));
+    REQUIRE_FALSE(std::filesystem::exists(paths.journal + ".tmp"));
+}
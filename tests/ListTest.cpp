@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "list/List.h"
+
+namespace {
+    // CountingResource считает живые выделения: у списка это число блоков
+    class CountingResource final : public std::pmr::memory_resource {
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+            ++allocations;
+            ++live;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, const size_t bytes, const size_t alignment) override {
+            --live;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        size_t allocations = 0;
+        size_t live = 0;
+    };
+
+    constexpr int kChunk = static_cast<int>(List<int>::kChunkCapacity);
+
+    List<int> filled(const int count, std::pmr::memory_resource *resource) {
+        List<int> list(resource);
+        for (int i = 0; i < count; ++i) {
+            list.push_back(i);
+        }
+        return list;
+    }
+
+    std::vector<int> forward(const List<int> &list) {
+        return {list.begin(), list.end()};
+    }
+
+    std::vector<int> backward(const List<int> &list) {
+        std::vector<int> out;
+        for (auto it = list.end(); it != list.begin();) {
+            out.push_back(*--it);
+        }
+        return out;
+    }
+
+    std::vector<int> iota(const int count) {
+        std::vector<int> out(count);
+        for (int i = 0; i < count; ++i) out[i] = i;
+        return out;
+    }
+}
+
+TEST_CASE("erase на границах блоков сохраняет порядок", "[list]") {
+    CountingResource resource;
+    auto list = filled(3 * kChunk + 5, &resource);
+    auto model = iota(3 * kChunk + 5);
+    REQUIRE(resource.live == 4);
+
+    // последний элемент первого блока: следующий итератор указывает в начало второго блока
+    auto it = std::next(list.begin(), kChunk - 1);
+    it = list.erase(it);
+    model.erase(model.begin() + kChunk - 1);
+    REQUIRE(*it == kChunk);
+    REQUIRE(forward(list) == model);
+
+    // первый элемент второго блока
+    it = list.erase(it);
+    model.erase(model.begin() + kChunk - 1);
+    REQUIRE(*it == kChunk + 1);
+    REQUIRE(forward(list) == model);
+    REQUIRE(list.count() == static_cast<int>(model.size()));
+
+    // удаление через итератор каждого второго элемента проходит через все блоки
+    bool drop = true;
+    for (auto pos = list.begin(); pos != list.end();) {
+        pos = drop ? list.erase(pos) : std::next(pos);
+        drop = !drop;
+    }
+    std::vector<int> kept;
+    for (size_t i = 1; i < model.size(); i += 2) kept.push_back(model[i]);
+    REQUIRE(forward(list) == kept);
+    REQUIRE(backward(list) == std::vector<int>(kept.rbegin(), kept.rend()));
+}
+
+TEST_CASE("Опустевший блок убирается из цепочки и освобождается", "[list]") {
+    CountingResource resource;
+
+    SECTION("erase опустошает средний блок") {
+        auto list = filled(3 * kChunk, &resource);
+        auto it = std::next(list.begin(), kChunk);
+        for (int i = 0; i < kChunk; ++i) {
+            it = list.erase(it);
+        }
+        REQUIRE(resource.live == 2);
+        REQUIRE(*it == 2 * kChunk);
+
+        std::vector<int> model = iota(3 * kChunk);
+        model.erase(model.begin() + kChunk, model.begin() + 2 * kChunk);
+        REQUIRE(forward(list) == model);
+        REQUIRE(backward(list) == std::vector<int>(model.rbegin(), model.rend()));
+    }
+
+    SECTION("del опустошает первый и последний блоки") {
+        List<int> list(&resource);
+        for (int i = 0; i < 3 * kChunk; ++i) {
+            list.push_back(i < kChunk || i >= 2 * kChunk ? -1 : i);
+        }
+        list.del(-1);
+        REQUIRE(resource.live == 1);
+        REQUIRE(list.count() == kChunk);
+        REQUIRE(list.get_first() == kChunk);
+        REQUIRE(*--list.end() == 2 * kChunk - 1);
+
+        // после удаления всех элементов блоков не остается, а список снова растет
+        list.del(kChunk);
+        while (!list.empty()) list.erase(list.begin());
+        REQUIRE(resource.live == 0);
+        REQUIRE(list.begin() == list.end());
+        list.push_back(7);
+        REQUIRE(forward(list) == std::vector<int>{7});
+    }
+}
+
+TEST_CASE("operator-- от end() переходит к последнему элементу", "[list]") {
+    CountingResource resource;
+    const int count = GENERATE(1, kChunk, kChunk + 1, 3 * kChunk + 2);
+    auto list = filled(count, &resource);
+
+    auto last = list.end();
+    --last;
+    REQUIRE(*last == count - 1);
+    REQUIRE(*std::prev(std::as_const(list).end()) == count - 1);
+    REQUIRE(backward(list) == [&] {
+        auto model = iota(count);
+        std::ranges::reverse(model);
+        return model;
+    }());
+
+    // после удаления последнего элемента end() ведет к новому хвосту
+    list.erase(last);
+    if (count > 1) {
+        REQUIRE(*--list.end() == count - 2);
+    } else {
+        REQUIRE(list.begin() == list.end());
+    }
+}
+
+TEST_CASE("Перемещение списка между ресурсами памяти", "[list]") {
+    CountingResource first;
+    CountingResource second;
+    auto source = filled(2 * kChunk + 3, &first);
+    const auto model = forward(source);
+
+    SECTION("тот же ресурс - блоки передаются без выделений") {
+        List<int> target(&first);
+        const auto allocations = first.allocations;
+        target = std::move(source);
+        REQUIRE(first.allocations == allocations);
+        REQUIRE(forward(target) == model);
+        REQUIRE(source.empty());
+    }
+
+    SECTION("другой ресурс - элементы переносятся в свою память") {
+        List<int> target(&second);
+        target.push_back(-1);
+        target = std::move(source);
+
+        REQUIRE(forward(target) == model);
+        REQUIRE(second.live == 3);
+        REQUIRE(first.live == 0);
+        REQUIRE(source.empty());
+        REQUIRE(source.begin() == source.end());
+    }
+
+    SECTION("конструктор перемещения забирает блоки вместе с ресурсом") {
+        const List<int> target(std::move(source));
+        REQUIRE(forward(target) == model);
+        REQUIRE(first.live == 3);
+        REQUIRE(second.allocations == 0);
+    }
+}
+
+TEST_CASE("add дописывает в конец без зацикливания", "[list]") {
+    List<std::string> list;
+    for (int i = 0; i < 3 * static_cast<int>(List<std::string>::kChunkCapacity) + 1; ++i) {
+        list.add(std::to_string(i));
+    }
+
+    // до исправления последний узел ссылался на первый, и обход не заканчивался
+    size_t steps = 0;
+    for (auto it = list.begin(); it != list.end() && steps <= static_cast<size_t>(list.count()); ++it) {
+        REQUIRE(*it == std::to_string(steps));
+        ++steps;
+    }
+    REQUIRE(steps == static_cast<size_t>(list.count()));
+    REQUIRE(*--list.end() == std::to_string(list.count() - 1));
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "repository/SchoolRepo.h"
+
+namespace {
+    std::string to_key(const model::PersonName &pn, const std::string &birth_date) {
+        return pn.to_string() + " " + birth_date;
+    }
+
+    using Row = std::tuple<std::uint32_t, std::string, std::uint32_t, std::string, int>;
+
+    Row row_of(const model::StudentGrade &sg) {
+        return {sg.get_grade_date().pack(), sg.get_student_name().to_string(), sg.get_birth_date().pack(),
+                sg.get_subject(), sg.get_grade()};
+    }
+
+    Row row_of(const model::Grade &grade) {
+        return {grade.get_date().pack(), grade.get_student_name().to_string(), grade.get_student_birth_date().pack(),
+                grade.get_subject(), grade.get_grade()};
+    }
+
+    std::string date_of(const size_t day) {
+        const char *months[] = {"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+        char text[32];
+        std::snprintf(text, sizeof(text), "%02zu %s %zu", day % 28 + 1, months[day / 28 % 12], 2000 + day / 336);
+        return text;
+    }
+
+    // FilterData - справочники во временных файлах: у каждой оценки своя дата, поэтому
+    // порядок по дате задает результат фильтра однозначно. Оценки записаны в случайном
+    // порядке, чтобы обход списка предмета и просмотр хранилища не совпадали с порядком дат
+    struct FilterData {
+        static constexpr size_t kGrades = 3000;
+
+        std::string students = (std::filesystem::temp_directory_path() / "school_repo_students.txt").string();
+        std::string grades = (std::filesystem::temp_directory_path() / "school_repo_grades.txt").string();
+        std::vector<std::string> birth_dates{"15 mar 2010", "02 sep 2011", "20 dec 2012"};
+
+        FilterData() {
+            clear();
+            const char *surnames[] = {"Иванов", "Петров", "Сидоров"};
+            const char *names[] = {"Артем", "Денис", "Михаил", "Олег", "Павел"};
+            const char *patronymics[] = {"Сергеевич", "Иванович"};
+
+            std::vector<std::pair<std::string, std::string>> people;
+            std::ofstream student_file(students);
+            for (const auto *surname: surnames)
+                for (const auto *name: names)
+                    for (const auto *patronymic: patronymics) {
+                        const auto &birth_date = birth_dates[people.size() % birth_dates.size()];
+                        people.emplace_back(std::string(surname) + " " + name + " " + patronymic, birth_date);
+                        student_file << people.back().first << '\t' << people.size() % 11 + 1 << '\t'
+                                << birth_date << '\n';
+                    }
+
+            std::mt19937 gen(34);
+            std::vector<size_t> days(kGrades);
+            for (size_t i = 0; i < kGrades; ++i) days[i] = i;
+            std::ranges::shuffle(days, gen);
+
+            // Химия - меньше восьмой части справочника, Математика и Физика - почти по половине
+            std::ofstream grade_file(grades);
+            for (const size_t day: days) {
+                const auto &[name, birth_date] = people[gen() % people.size()];
+                const auto roll = gen() % 20;
+                const char *subject = roll < 2 ? "Химия" : roll < 11 ? "Математика" : "Физика";
+                grade_file << name << '\t' << birth_date << '\t' << subject << '\t' << gen() % 4 + 2 << '\t'
+                        << date_of(day) << '\n';
+            }
+        }
+
+        ~FilterData() { clear(); }
+
+        void clear() const {
+            for (const auto &path: {grades + ".journal", grades + ".snap", grades + ".tmp", students + ".tmp"})
+                std::filesystem::remove(path);
+        }
+    };
+}
+
+TEST_CASE("get_filtered совпадает с полным перебором при любом выбранном индексе", "[school-repo]") {
+    const FilterData data;
+    repo::SchoolRepo repo(data.students, data.grades, to_key);
+    const auto grades = repo.grades();
+    REQUIRE(grades.size() == FilterData::kGrades);
+
+    struct Query {
+        const char *name;
+        const char *subject;
+        size_t first_day;
+        size_t last_day;
+    };
+    // узкий период - обход дерева дат, редкий предмет - список предмета, частый предмет
+    // за весь срок - просмотр хранилища ядром фильтра
+    const auto query = GENERATE(
+        Query{"дерево дат", "Математика", 1000, 1200},
+        Query{"список предмета", "Химия", 0, FilterData::kGrades - 1},
+        Query{"ядро фильтра", "Физика", 0, FilterData::kGrades - 1});
+    const auto birth_date = model::Date::parse(GENERATE_REF(from_range(data.birth_dates)));
+
+    INFO(query.name);
+    const auto low = model::Date::parse(date_of(query.first_day));
+    const auto high = model::Date::parse(date_of(query.last_day));
+
+    std::vector<Row> expected;
+    for (const auto &grade: grades) {
+        if (grade.get_subject() == query.subject && grade.get_student_birth_date() == birth_date &&
+            !(grade.get_date() < low) && !(grade.get_date() > high))
+            expected.push_back(row_of(grade));
+    }
+    std::ranges::sort(expected);
+    REQUIRE_FALSE(expected.empty());
+
+    size_t steps = 0;
+    const auto filtered = repo.get_filtered(birth_date, query.subject, low, high, steps);
+    std::vector<Row> actual;
+    for (const auto &sg: filtered) {
+        actual.push_back(row_of(sg));
+    }
+    REQUIRE(actual == expected);
+}
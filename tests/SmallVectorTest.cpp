@@ -0,0 +1,171 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "vector/SmallVector.h"
+
+namespace {
+    // Tracked считает живые экземпляры, чтобы проверить, что переносы ничего не теряют
+    // и не разрушают дважды
+    struct Tracked {
+        static inline int alive = 0;
+
+        std::string value;
+
+        explicit Tracked(std::string value) : value(std::move(value)) { ++alive; }
+        Tracked(const Tracked &other) : value(other.value) { ++alive; }
+        Tracked(Tracked &&other) noexcept : value(std::move(other.value)) { ++alive; }
+        Tracked &operator=(const Tracked &) = default;
+        Tracked &operator=(Tracked &&) noexcept = default;
+        ~Tracked() { --alive; }
+    };
+
+    // is_inline - лежат ли элементы во встроенном буфере самого объекта
+    template<typename V>
+    bool is_inline(const V &v) {
+        const auto *data = reinterpret_cast<const std::byte *>(v.data());
+        const auto *self = reinterpret_cast<const std::byte *>(&v);
+        return data >= self && data < self + sizeof(V);
+    }
+
+    template<typename V>
+    std::vector<std::string> values(const V &v) {
+        std::vector<std::string> out;
+        for (const auto &item: v) out.push_back(item.value);
+        return out;
+    }
+
+    template<size_t N>
+    SmallVector<Tracked, N> filled(const size_t count) {
+        SmallVector<Tracked, N> v;
+        for (size_t i = 0; i < count; ++i) {
+            v.emplace_back("значение " + std::to_string(i));
+        }
+        return v;
+    }
+}
+
+TEST_CASE("Перемещение между встроенным буфером и кучей", "[small-vector]") {
+    {
+        SECTION("конструктор из встроенного буфера переносит элементы по одному") {
+            auto source = filled<4>(3);
+            REQUIRE(is_inline(source));
+            const auto expected = values(source);
+
+            SmallVector<Tracked, 4> target(std::move(source));
+            REQUIRE(is_inline(target));
+            REQUIRE(values(target) == expected);
+            REQUIRE(source.empty());
+            REQUIRE(is_inline(source));
+            REQUIRE(Tracked::alive == 3);
+        }
+
+        SECTION("конструктор из кучи забирает блок") {
+            auto source = filled<4>(10);
+            REQUIRE_FALSE(is_inline(source));
+            const auto *data = source.data();
+            const auto expected = values(source);
+
+            SmallVector<Tracked, 4> target(std::move(source));
+            REQUIRE(target.data() == data);
+            REQUIRE(values(target) == expected);
+            REQUIRE(source.empty());
+            REQUIRE(is_inline(source));
+            REQUIRE(source.capacity() == 4);
+
+            // источник остается пригодным
+            source.emplace_back("снова");
+            REQUIRE(source.size() == 1);
+        }
+
+        SECTION("присваивание из встроенного буфера в вектор с кучей") {
+            auto target = filled<4>(10);
+            auto source = filled<4>(2);
+
+            target = std::move(source);
+            REQUIRE(is_inline(target));
+            REQUIRE(target.capacity() == 4);
+            REQUIRE(values(target) == std::vector<std::string>{"значение 0", "значение 1"});
+            REQUIRE(Tracked::alive == 2);
+        }
+
+        SECTION("присваивание из кучи во встроенный буфер") {
+            auto target = filled<4>(2);
+            auto source = filled<4>(10);
+            const auto *data = source.data();
+
+            target = std::move(source);
+            REQUIRE(target.data() == data);
+            REQUIRE(target.size() == 10);
+            REQUIRE(is_inline(source));
+            REQUIRE(Tracked::alive == 10);
+        }
+    }
+    REQUIRE(Tracked::alive == 0);
+}
+
+TEST_CASE("shrink_to_fit возвращает элементы во встроенный буфер", "[small-vector]") {
+    {
+        auto v = filled<4>(10);
+        REQUIRE_FALSE(is_inline(v));
+
+        // лишняя емкость кучи отдается, но элементов больше, чем помещается во встроенный буфер
+        v.pop_back();
+        v.pop_back();
+        v.shrink_to_fit();
+        REQUIRE_FALSE(is_inline(v));
+        REQUIRE(v.capacity() == 8);
+
+        while (v.size() > 3) v.pop_back();
+        v.shrink_to_fit();
+        REQUIRE(is_inline(v));
+        REQUIRE(v.capacity() == 4);
+        REQUIRE(values(v) == std::vector<std::string>{"значение 0", "значение 1", "значение 2"});
+        REQUIRE(Tracked::alive == 3);
+
+        // во встроенном буфере shrink_to_fit ничего не делает
+        v.shrink_to_fit();
+        REQUIRE(is_inline(v));
+        REQUIRE(v.size() == 3);
+    }
+    REQUIRE(Tracked::alive == 0);
+}
+
+TEST_CASE("emplace в середину во встроенном буфере, на границе и в куче", "[small-vector]") {
+    {
+        SmallVector<Tracked, 4> v;
+        std::vector<std::string> model;
+
+        // вставки в середину проходят через все три состояния: есть место во встроенном
+        // буфере, буфер заполнен и элементы переезжают в кучу, место есть в куче
+        for (size_t i = 0; i < 12; ++i) {
+            const auto value = "вставка " + std::to_string(i);
+            const size_t pos = v.size() / 2;
+            const auto it = v.emplace(v.begin() + pos, value);
+            model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos), value);
+
+            REQUIRE(it == v.begin() + pos);
+            REQUIRE(it->value == value);
+            REQUIRE(values(v) == model);
+            REQUIRE(is_inline(v) == (v.size() <= 4));
+        }
+        REQUIRE(Tracked::alive == 12);
+
+        // аргумент из самого вектора
+        v.emplace(v.begin() + 1, v[5]);
+        model.insert(model.begin() + 1, model[5]);
+        REQUIRE(values(v) == model);
+    }
+    REQUIRE(Tracked::alive == 0);
+
+    SmallVector<int, 4> ints;
+    std::vector<int> model;
+    for (int i = 0; i < 12; ++i) {
+        const size_t pos = ints.size() / 2;
+        ints.emplace(ints.begin() + pos, i);
+        model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos), i);
+    }
+    REQUIRE(std::vector<int>(ints.begin(), ints.end()) == model);
+}
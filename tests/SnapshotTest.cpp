@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "repository/SchoolRepo.h"
+#include "utils/MappedFile.h"
+
+namespace {
+    std::string to_key(const model::PersonName &pn, const std::string &birth_date) {
+        return pn.to_string() + " " + birth_date;
+    }
+
+    const char *kSubjects[] = {"Математика", "Физика", "Химия", "Литература"};
+
+    // SnapshotData - справочники во временных файлах и снимок рядом с ними, записанный первым
+    // переносом журнала
+    struct SnapshotData {
+        static constexpr size_t kGrades = 1200;
+
+        std::string students = (std::filesystem::temp_directory_path() / "snapshot_students.txt").string();
+        std::string grades = (std::filesystem::temp_directory_path() / "snapshot_grades.txt").string();
+        std::string snapshot = repo::Snapshot::path_for(grades);
+
+        SnapshotData() {
+            clear();
+            const char *surnames[] = {"Иванов", "Петров", "Сидоров", "Орлов"};
+            const char *names[] = {"Артем", "Денис", "Михаил", "Олег", "Павел"};
+            const char *months[] = {"jan", "feb", "mar", "apr", "may", "sep", "oct", "nov", "dec"};
+
+            std::mt19937 gen(49);
+            std::vector<std::pair<std::string, std::string>> people;
+            std::ofstream student_file(students);
+            for (const auto *surname: surnames)
+                for (const auto *name: names) {
+                    char birth_date[32];
+                    std::snprintf(birth_date, sizeof(birth_date), "%02u %s %u", gen() % 28 + 1, months[gen() % 9],
+                                  2009 + gen() % 3);
+                    people.emplace_back(std::string(surname) + " " + name + " Сергеевич", birth_date);
+                    student_file << people.back().first << '\t' << gen() % 11 + 1 << '\t' << birth_date << '\n';
+                }
+
+            // у каждой оценки своя дата - дубликатов, на которых загрузка остановилась бы, нет
+            std::ofstream grade_file(grades);
+            for (size_t i = 0; i < kGrades; ++i) {
+                const auto &[name, birth_date] = people[gen() % people.size()];
+                grade_file << name << '\t' << birth_date << '\t' << kSubjects[gen() % 4] << '\t' << gen() % 4 + 2
+                        << '\t' << i % 28 + 1 << ' ' << months[i / 28 % 9] << ' ' << 2020 + i / 252 << '\n';
+            }
+            student_file.close();
+            grade_file.close();
+
+            // первый перенос журнала переписывает файлы и снимает с них снимок
+            repo::SchoolRepo repo(students, grades, to_key);
+            repo.commit_journal();
+            repo.close_journal();
+        }
+
+        ~SnapshotData() { clear(); }
+
+        void clear() const {
+            for (const auto &path: {students, grades, snapshot, grades + ".journal", snapshot + ".tmp",
+                                    grades + ".tmp", students + ".tmp"})
+                std::filesystem::remove(path);
+        }
+
+        [[nodiscard]] std::optional<repo::Snapshot> open() const {
+            return repo::Snapshot::open(snapshot, students, grades);
+        }
+    };
+
+    // tree_order - ключи дерева в порядке обхода вместе со списками номеров оценок
+    template<typename Tree>
+    auto tree_order(const Tree &tree) {
+        std::vector<std::pair<decltype(tree.begin()->key), std::vector<int>>> order;
+        for (const auto &node: tree) {
+            std::vector<int> ids;
+            for (const int id: node.list) ids.push_back(id);
+            order.emplace_back(node.key, std::move(ids));
+        }
+        return order;
+    }
+
+    std::vector<std::string> filtered(repo::SchoolRepo &repo, const model::Date &birth_date, const char *subject) {
+        size_t steps = 0;
+        std::vector<std::string> rows;
+        for (const auto &sg: repo.get_filtered(birth_date, subject, model::Date::parse("01 jan 2020"),
+                                               model::Date::parse("31 dec 2024"), steps)) {
+            rows.push_back(sg.to_string());
+        }
+        return rows;
+    }
+
+    void flip_byte(const std::string &path, const std::streamoff offset) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(offset);
+        const auto byte = static_cast<char>(file.get());
+        file.seekp(offset);
+        file.put(static_cast<char>(byte ^ 0x5a));
+    }
+}
+
+TEST_CASE("Справочники из снимка совпадают с загруженными из текста", "[snapshot]") {
+    const SnapshotData data;
+    REQUIRE(data.open().has_value());
+
+    // справочник из текста снова снимает снимок: нагрузка хранит его порядок записей
+    std::filesystem::remove(data.snapshot);
+    repo::SchoolRepo from_text(data.students, data.grades, to_key);
+    from_text.commit_journal();
+    from_text.close_journal();
+    REQUIRE(data.open().has_value());
+
+    repo::SchoolRepo from_snapshot(data.students, data.grades, to_key);
+
+    REQUIRE(std::ranges::equal(from_snapshot.students(), from_text.students()));
+    REQUIRE(std::ranges::equal(from_snapshot.grades(), from_text.grades()));
+    REQUIRE(tree_order(from_snapshot.key_tree()) == tree_order(from_text.key_tree()));
+    REQUIRE(tree_order(from_snapshot.date_tree()) == tree_order(from_text.date_tree()));
+
+    for (const auto &student: from_text.students()) {
+        for (const auto *subject: kSubjects) {
+            REQUIRE(filtered(from_snapshot, student.get_birth_date(), subject) ==
+                    filtered(from_text, student.get_birth_date(), subject));
+        }
+    }
+
+    // справочник из снимка изменяется так же, как загруженный из текста
+    const auto grade = from_text.grades()[0];
+    REQUIRE(from_snapshot.del_grade(grade));
+    REQUIRE(from_snapshot.add_grade(model::Grade(grade)));
+    REQUIRE(from_snapshot.grade_repo_size() == from_text.grade_repo_size());
+}
+
+TEST_CASE("Снимок с измененным байтом нагрузки не используется", "[snapshot]") {
+    const SnapshotData data;
+    const size_t payload = std::filesystem::file_size(data.snapshot) - sizeof(repo::SnapshotHeader);
+    const auto offset = GENERATE_COPY(size_t{0}, payload / 2, payload - 1);
+
+    flip_byte(data.snapshot, static_cast<std::streamoff>(sizeof(repo::SnapshotHeader) + offset));
+    REQUIRE_FALSE(data.open().has_value());
+
+    const repo::SchoolRepo repo(data.students, data.grades, to_key);
+    REQUIRE(repo.grade_repo_size() == SnapshotData::kGrades);
+}
+
+TEST_CASE("Снимок устаревает, когда текстовый файл меняется", "[snapshot]") {
+    const SnapshotData data;
+
+    SECTION("время изменения") {
+        const auto path = GENERATE_REF(data.students, data.grades);
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(2));
+    }
+    SECTION("размер") {
+        std::ofstream(data.grades, std::ios::app) << '\n';
+    }
+
+    REQUIRE_FALSE(data.open().has_value());
+    const repo::SchoolRepo repo(data.students, data.grades, to_key);
+    REQUIRE(repo.grade_repo_size() == SnapshotData::kGrades);
+}
+
+TEST_CASE("Обрезанный снимок не используется", "[snapshot]") {
+    const SnapshotData data;
+    const size_t size = std::filesystem::file_size(data.snapshot);
+    const auto truncated = GENERATE_COPY(size - 1, sizeof(repo::SnapshotHeader),
+                                         sizeof(repo::SnapshotHeader) - 1, size_t{0});
+
+    std::filesystem::resize_file(data.snapshot, truncated);
+    REQUIRE_FALSE(data.open().has_value());
+
+    const repo::SchoolRepo repo(data.students, data.grades, to_key);
+    REQUIRE(repo.grade_repo_size() == SnapshotData::kGrades);
+}
+
+TEST_CASE("MappedFile отображает содержимое файла", "[snapshot]") {
+    const auto path = (std::filesystem::temp_directory_path() / "mapped_file.bin").string();
+    const std::string content = GENERATE(std::string(), std::string("журнал"), std::string(100000, 'x'));
+    std::ofstream(path, std::ios::binary) << content;
+
+    {
+        utils::MappedFile file(path);
+        REQUIRE(file.size() == content.size());
+        REQUIRE(std::string(reinterpret_cast<const char *>(file.bytes().data()), file.size()) == content);
+
+        // перемещенное отображение остается действительным
+        const utils::MappedFile moved(std::move(file));
+        REQUIRE(moved.size() == content.size());
+        REQUIRE(file.size() == 0);
+    }
+    std::filesystem::remove(path);
+
+    REQUIRE_THROWS_AS(utils::MappedFile(path), std::runtime_error);
+}
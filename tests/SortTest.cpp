@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "sort/Sort.h"
+#include "utils/ThreadPool.h"
+#include "vector/Vector.h"
+
+using sort::Order;
+
+namespace {
+    struct Item {
+        int key = 0, id = 0;
+    };
+
+    // fillItems заполняет массив ключами из [0, maxKey] и номерами по порядку. Узкий диапазон
+    // ключей дает много равных ключей, на которых проверяется устойчивость
+    Vector<Item> fillItems(const size_t size, const int maxKey, const unsigned seed) {
+        Vector<Item> items(size);
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution dist(0, maxKey);
+        for (size_t i = 0; i < size; ++i) {
+            items[i] = {dist(gen), static_cast<int>(i)};
+        }
+        return items;
+    }
+
+    bool isOrdered(const Vector<Item> &items, const Order order) {
+        for (size_t i = 1; i < items.size(); ++i) {
+            if (order == Order::ASC ? items[i].key < items[i - 1].key : items[i].key > items[i - 1].key) return false;
+        }
+        return true;
+    }
+
+    // isStable проверяет, что равные ключи сохранили исходный порядок номеров
+    bool isStable(const Vector<Item> &items) {
+        for (size_t i = 1; i < items.size(); ++i) {
+            if (items[i].key == items[i - 1].key && items[i].id < items[i - 1].id) return false;
+        }
+        return true;
+    }
+
+    // isPermutation проверяет, что сортировка ничего не потеряла и не продублировала
+    bool isPermutation(const Vector<Item> &items) {
+        Vector<int> ids(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            ids[i] = items[i].id;
+        }
+        std::sort(ids.begin(), ids.end());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (ids[i] != static_cast<int>(i)) return false;
+        }
+        return true;
+    }
+
+    // sortWith вызывает сортировку сравнением с компаратором, соответствующим порядку
+    template<typename Sorter>
+    void sortWith(Sorter &&sorter, Vector<Item> &items, const Order order) {
+        if (order == Order::ASC) sorter(items.begin(), items.end(), std::less<>{});
+        else sorter(items.begin(), items.end(), std::greater<>{});
+    }
+
+    const auto byKey = &Item::key;
+}
+
+TEST_CASE("pdqSort упорядочивает", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    const size_t size = GENERATE(0, 1, 2, 23, 1000, 100000);
+    // maxKey = 0 - все ключи равны, большой maxKey - почти все различны
+    const int maxKey = GENERATE(0, 7, 1 << 30);
+
+    auto items = fillItems(size, maxKey, 11);
+    sortWith([](auto first, auto last, auto comp) { sort::pdqSort(first, last, comp, byKey); }, items, order);
+
+    REQUIRE(isOrdered(items, order));
+    REQUIRE(isPermutation(items));
+}
+
+TEST_CASE("pdqSort на упорядоченных и обратных данных", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    auto items = fillItems(50000, 1 << 30, 3);
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) { return a.key < b.key; });
+    const bool reversed = GENERATE(false, true);
+    if (reversed) std::reverse(items.begin(), items.end());
+
+    sortWith([](auto first, auto last, auto comp) { sort::pdqSort(first, last, comp, byKey); }, items, order);
+
+    REQUIRE(isOrdered(items, order));
+    REQUIRE(isPermutation(items));
+}
+
+TEST_CASE("stableSort упорядочивает и сохраняет порядок равных", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    const size_t size = GENERATE(0, 1, 2, 23, 1000, 100000);
+
+    auto items = fillItems(size, static_cast<int>(size / 8), 2025);
+    sortWith([](auto first, auto last, auto comp) { sort::stableSort(first, last, comp, byKey); }, items, order);
+
+    REQUIRE(isOrdered(items, order));
+    REQUIRE(isStable(items));
+    REQUIRE(isPermutation(items));
+}
+
+TEST_CASE("parallelStableSort упорядочивает и сохраняет порядок равных", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    // короткий массив сортируется в вызывающем потоке, длинный делится на части
+    const size_t size = GENERATE(1000, 100000, 300001);
+    // отдельный пул, чтобы параллельная ветка проверялась и на машине с одним ядром
+    utils::ThreadPool pool(4);
+
+    auto items = fillItems(size, static_cast<int>(size / 8), 2025);
+    sortWith([&pool](auto first, auto last, auto comp) { sort::parallelStableSort(first, last, comp, byKey, pool); },
+             items, order);
+
+    REQUIRE(isOrdered(items, order));
+    REQUIRE(isStable(items));
+    REQUIRE(isPermutation(items));
+}
+
+TEST_CASE("radixSort упорядочивает и сохраняет порядок равных", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    // до 64 элементов radixSort передает работу stableSort
+    const size_t size = GENERATE(0, 1, 23, 1000, 100000);
+
+    auto items = fillItems(size, static_cast<int>(size / 8), 2025);
+    sort::radixSort(items.begin(), items.end(), byKey, order);
+
+    REQUIRE(isOrdered(items, order));
+    REQUIRE(isStable(items));
+    REQUIRE(isPermutation(items));
+}
+
+TEST_CASE("radixSort упорядочивает отрицательные ключи", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    auto items = fillItems(10000, 2000, 9);
+    for (auto &item: items) {
+        item.key -= 1000;
+    }
+
+    sort::radixSort(items.begin(), items.end(), byKey, order);
+
+    REQUIRE(isOrdered(items, order));
+    REQUIRE(isStable(items));
+}
+
+TEST_CASE("insertionSort и shellSort упорядочивают", "[sort]") {
+    const auto order = GENERATE(Order::ASC, Order::DESC);
+    auto items = fillItems(1000, 125, 2025);
+    Vector<int> keys(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        keys[i] = items[i].key;
+    }
+
+    sort::insertionSort(keys.data(), static_cast<int>(keys.size()), order);
+    REQUIRE(std::is_sorted(keys.begin(), keys.end(), [order](const int a, const int b) {
+        return order == Order::ASC ? a < b : a > b;
+    }));
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        keys[i] = items[i].key;
+    }
+    sort::shellSort(keys.data(), static_cast<int>(keys.size()), order);
+    REQUIRE(std::is_sorted(keys.begin(), keys.end(), [order](const int a, const int b) {
+        return order == Order::ASC ? a < b : a > b;
+    }));
+}
+
+TEST_CASE("Пропускная способность сортировок", "[sort][benchmark]") {
+    // каждый замер копирует исходный массив, чтобы сортировать неупорядоченные данные;
+    // копия занимает малую долю времени сортировки
+    const auto input = fillItems(1 << 20, 1 << 20, 7);
+
+    BENCHMARK("pdqSort") {
+        auto items = input;
+        sort::pdqSort(items.begin(), items.end(), std::less<>{}, byKey);
+        return items[0].key;
+    };
+
+    BENCHMARK("stableSort") {
+        auto items = input;
+        sort::stableSort(items.begin(), items.end(), std::less<>{}, byKey);
+        return items[0].key;
+    };
+
+    BENCHMARK("parallelStableSort") {
+        auto items = input;
+        sort::parallelStableSort(items.begin(), items.end(), std::less<>{}, byKey);
+        return items[0].key;
+    };
+
+    BENCHMARK("radixSort") {
+        auto items = input;
+        sort::radixSort(items.begin(), items.end(), byKey);
+        return items[0].key;
+    };
+
+    BENCHMARK("std::stable_sort") {
+        auto items = input;
+        std::stable_sort(items.begin(), items.end(), [](const Item &a, const Item &b) { return a.key < b.key; });
+        return items[0].key;
+    };
+}
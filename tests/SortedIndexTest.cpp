@@ -0,0 +1,161 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "repository/SchoolRepo.h"
+#include "sort/Sort.h"
+
+namespace {
+    std::string to_key(const model::PersonName &pn, const std::string &birth_date) {
+        return pn.to_string() + " " + birth_date;
+    }
+
+    // date_of - n-я по счету дата; разные n дают разные даты, поэтому новые студенты
+    // и оценки не совпадают с уже записанными
+    model::Date date_of(const size_t n, const int first_year) {
+        const char *months[] = {"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+        char text[32];
+        std::snprintf(text, sizeof(text), "%02zu %s %zu", n % 28 + 1, months[n / 28 % 12], first_year + n / 336);
+        return model::Date::parse(text);
+    }
+
+    const char *kNames[] = {"Иванов Артем Сергеевич", "Петров Денис Олегович", "Сидоров Михаил Павлович",
+                            "Орлов Павел Иванович", "Кузнецов Олег Денисович"};
+    const char *kSubjects[] = {"Математика", "Физика", "Химия"};
+
+    // matches_fresh_sort проверяет, что order - перестановка [0, count), а ключи в ее порядке
+    // совпадают с заново отсортированными. Порядок равных ключей не сравнивается: после
+    // удаления последняя запись меняет индекс, но остается на своем месте среди равных
+    template<typename KeyOf>
+    bool matches_fresh_sort(const std::span<const std::uint32_t> order, const size_t count, KeyOf &&key_of) {
+        if (order.size() != count) return false;
+
+        std::vector<bool> seen(count);
+        for (const auto row: order) {
+            if (row >= count || seen[row]) return false;
+            seen[row] = true;
+        }
+
+        std::vector<std::uint32_t> fresh(count);
+        std::iota(fresh.begin(), fresh.end(), 0u);
+        sort::sortBy(fresh.begin(), fresh.end(), key_of);
+
+        for (size_t k = 0; k < count; ++k) {
+            if (key_of(order[k]) != key_of(fresh[k])) return false;
+        }
+        return true;
+    }
+
+    bool students_sorted(repo::SchoolRepo &repo) {
+        const auto students = repo.student_view();
+        const auto count = students.size();
+        return matches_fresh_sort(repo.sorted_students(repo::StudentColumn::Name), count,
+                                  [&](const std::uint32_t row) { return students[row].get_name().collation_key(); })
+               && matches_fresh_sort(repo.sorted_students(repo::StudentColumn::Class), count,
+                                     [&](const std::uint32_t row) { return students[row].get_class(); })
+               && matches_fresh_sort(repo.sorted_students(repo::StudentColumn::BirthDate), count,
+                                     [&](const std::uint32_t row) { return students[row].get_birth_date().pack(); });
+    }
+
+    bool grades_sorted(repo::SchoolRepo &repo) {
+        const auto count = repo.grade_repo_size();
+        const auto view = [&repo](const std::uint32_t row) { return repo.grade_view(row); };
+        return matches_fresh_sort(repo.sorted_grades(repo::GradeColumn::Student), count,
+                                  [&](const std::uint32_t row) {
+                                      return view(row).get_student_name().collation_key();
+                                  })
+               && matches_fresh_sort(repo.sorted_grades(repo::GradeColumn::BirthDate), count,
+                                     [&](const std::uint32_t row) {
+                                         return view(row).get_student_birth_date().pack();
+                                     })
+               && matches_fresh_sort(repo.sorted_grades(repo::GradeColumn::Subject), count,
+                                     [&](const std::uint32_t row) { return view(row).get_subject(); })
+               && matches_fresh_sort(repo.sorted_grades(repo::GradeColumn::Grade), count,
+                                     [&](const std::uint32_t row) { return view(row).get_grade(); })
+               && matches_fresh_sort(repo.sorted_grades(repo::GradeColumn::Date), count,
+                                     [&](const std::uint32_t row) { return view(row).get_date().pack(); });
+    }
+}
+
+TEST_CASE("Перестановки столбцов совпадают с сортировкой после каждого изменения", "[sorted-index]") {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto students_path = (dir / "sorted_index_students.txt").string();
+    const auto grades_path = (dir / "sorted_index_grades.txt").string();
+
+    std::mt19937 gen(48);
+    size_t next_student = 0;
+    size_t next_grade = 0;
+    const auto new_student = [&] {
+        return model::Student(model::PersonName::parse(kNames[gen() % 5]), static_cast<int>(gen() % 11 + 1),
+                              date_of(next_student++, 2008));
+    };
+    const auto new_grade = [&](const model::Student &student) {
+        return model::Grade(student.get_name(), student.get_birth_date(), kSubjects[gen() % 3],
+                            static_cast<int>(gen() % 4 + 2), date_of(next_grade++, 2020));
+    };
+
+    std::vector<model::Student> initial;
+    {
+        std::ofstream student_file(students_path);
+        std::ofstream grade_file(grades_path);
+        for (size_t i = 0; i < 30; ++i) {
+            initial.push_back(new_student());
+            student_file << initial.back().to_string() << '\n';
+        }
+        for (size_t i = 0; i < 200; ++i) {
+            grade_file << new_grade(initial[gen() % initial.size()]).to_string() << '\n';
+        }
+    }
+
+    {
+        repo::SchoolRepo repo(students_path, grades_path, to_key, 1024);
+        REQUIRE(students_sorted(repo));
+        REQUIRE(grades_sorted(repo));
+
+        for (size_t step = 0; step < 400; ++step) {
+            INFO("шаг " << step);
+            const auto students = repo.student_view();
+
+            switch (students.empty() ? 0 : gen() % 4) {
+                case 0:
+                    REQUIRE(repo.add_student(new_student()));
+                    break;
+                case 1: {
+                    // студента с оценками удалить нельзя - тогда удаляются его оценки
+                    const auto student = students[gen() % students.size()];
+                    size_t steps = 0;
+                    const auto grades = repo.search_grades(
+                        to_key(student.get_name(), student.get_birth_date().to_string()), steps);
+                    if (grades.empty())
+                        REQUIRE(repo.del_student(student));
+                    for (const auto &grade: grades)
+                        REQUIRE(repo.del_grade(grade));
+                    break;
+                }
+                case 2:
+                    REQUIRE(repo.add_grade(new_grade(students[gen() % students.size()])));
+                    break;
+                default:
+                    if (repo.grade_repo_size() > 0) {
+                        const auto grades = repo.grades();
+                        REQUIRE(repo.del_grade(grades[gen() % grades.size()]));
+                    }
+                    break;
+            }
+
+            REQUIRE(students_sorted(repo));
+            REQUIRE(grades_sorted(repo));
+        }
+    }
+
+    for (const auto &path: {students_path, grades_path, grades_path + ".journal"})
+        std::filesystem::remove(path);
+}
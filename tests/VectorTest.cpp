@@ -0,0 +1,213 @@
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+
+#include <catch/catch_amalgamated.hpp>
+
+#include "vector/Vector.h"
+
+namespace {
+    // ThrowingCopy бросает исключение на копировании, когда заданный запас копий исчерпан.
+    // Перемещение не помечено noexcept, поэтому при росте вектор копирует элементы
+    struct ThrowingCopy {
+        static inline int copies_left = -1;
+        static inline int alive = 0;
+
+        int value;
+
+        explicit ThrowingCopy(const int value) : value(value) { ++alive; }
+
+        ThrowingCopy(const ThrowingCopy &other) : value(other.value) {
+            if (copies_left == 0) throw std::runtime_error("копирование запрещено");
+            if (copies_left > 0) --copies_left;
+            ++alive;
+        }
+
+        ThrowingCopy(ThrowingCopy &&other) : value(other.value) { ++alive; }
+
+        ThrowingCopy &operator=(const ThrowingCopy &) = default;
+        ~ThrowingCopy() { --alive; }
+    };
+
+    struct Pod {
+        int id;
+        double weight;
+    };
+
+    // CountingResource считает выделения поверх стандартной кучи
+    class CountingResource final : public std::pmr::memory_resource {
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, const size_t bytes, const size_t alignment) override {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        size_t allocations = 0;
+        size_t deallocations = 0;
+    };
+}
+
+TEST_CASE("Рост вектора со строгой гарантией, если копирование бросает", "[vector]") {
+    {
+        Vector<ThrowingCopy> v;
+        v.reserve(8);
+        for (int i = 0; i < 8; ++i) {
+            v.emplace_back(i);
+        }
+        const auto *data = v.data();
+
+        // перенос бросает на третьем элементе из восьми
+        ThrowingCopy::copies_left = 2;
+        REQUIRE_THROWS_AS(v.emplace_back(8), std::runtime_error);
+        ThrowingCopy::copies_left = -1;
+
+        REQUIRE(v.size() == 8);
+        REQUIRE(v.capacity() == 8);
+        REQUIRE(v.data() == data);
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(v[i].value == i);
+        }
+        REQUIRE(ThrowingCopy::alive == 8);
+
+        // reserve дает ту же гарантию
+        ThrowingCopy::copies_left = 0;
+        REQUIRE_THROWS_AS(v.reserve(32), std::runtime_error);
+        ThrowingCopy::copies_left = -1;
+        REQUIRE(v.capacity() == 8);
+        REQUIRE(ThrowingCopy::alive == 8);
+
+        v.emplace_back(8);
+        REQUIRE(v.size() == 9);
+        REQUIRE(v[8].value == 8);
+    }
+    REQUIRE(ThrowingCopy::alive == 0);
+}
+
+TEST_CASE("emplace_back и emplace с аргументом из самого вектора", "[vector]") {
+    Vector<std::string> v;
+    v.push_back(std::string(40, 'a'));
+    v.push_back(std::string(40, 'b'));
+    v.shrink_to_fit();
+    REQUIRE(v.size() == v.capacity());
+
+    // новый блок выделяется, пока v[0] еще жив
+    v.emplace_back(v[0]);
+    REQUIRE(v[2] == std::string(40, 'a'));
+
+    while (v.size() < v.capacity()) v.emplace_back("x");
+    v.push_back(v.back());
+    REQUIRE(v.back() == "x");
+
+    // вставка в середину сдвигает элемент, на который ссылается аргумент
+    v.emplace(v.begin(), v[1]);
+    REQUIRE(v[0] == std::string(40, 'b'));
+    REQUIRE(v[1] == std::string(40, 'a'));
+    REQUIRE(v[2] == std::string(40, 'b'));
+}
+
+TEST_CASE("Тривиально копируемые элементы переносятся побайтно", "[vector]") {
+    static_assert(std::is_trivially_copyable_v<Pod>);
+
+    Vector<Pod> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back({i, i * 0.5});
+    }
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(v[i].id == i);
+    }
+
+    // вставка и удаление в середине сдвигают хвост memmove
+    v.emplace(v.begin() + 10, Pod{-1, -1.0});
+    REQUIRE(v[9].id == 9);
+    REQUIRE(v[10].id == -1);
+    REQUIRE(v[11].id == 10);
+    REQUIRE(v.back().id == 999);
+
+    v.erase(v.begin() + 10);
+    v.erase(v.begin());
+    REQUIRE(v.size() == 999);
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(v[i].id == i + 1);
+        REQUIRE(v[i].weight == (i + 1) * 0.5);
+    }
+}
+
+TEST_CASE("shrink_to_fit отдает лишнюю емкость", "[vector]") {
+    Vector<std::string> v;
+    v.reserve(100);
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(std::to_string(i));
+    }
+
+    v.shrink_to_fit();
+    REQUIRE(v.capacity() == 10);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(v[i] == std::to_string(i));
+    }
+
+    v.clear();
+    v.shrink_to_fit();
+    REQUIRE(v.capacity() == 0);
+    REQUIRE(v.data() == nullptr);
+
+    v.push_back("снова");
+    REQUIRE(v.size() == 1);
+}
+
+TEST_CASE("Перемещение PmrVector учитывает ресурс памяти", "[vector]") {
+    CountingResource first;
+    CountingResource second;
+
+    PmrVector<std::string> source{std::pmr::polymorphic_allocator<std::string>(&first)};
+    for (int i = 0; i < 20; ++i) {
+        source.push_back(std::to_string(i));
+    }
+
+    SECTION("тот же ресурс - блок забирается целиком") {
+        PmrVector<std::string> target{std::pmr::polymorphic_allocator<std::string>(&first)};
+        const auto *data = source.data();
+        const auto allocations = first.allocations;
+
+        target = std::move(source);
+        REQUIRE(target.data() == data);
+        REQUIRE(first.allocations == allocations);
+        REQUIRE(source.empty());
+        REQUIRE(target.size() == 20);
+    }
+
+    SECTION("другой ресурс - элементы переносятся в свою память") {
+        PmrVector<std::string> target{std::pmr::polymorphic_allocator<std::string>(&second)};
+        const auto *data = source.data();
+
+        target = std::move(source);
+        REQUIRE(target.data() != data);
+        REQUIRE(second.allocations == 1);
+        REQUIRE(source.empty());
+        REQUIRE(target.size() == 20);
+        for (int i = 0; i < 20; ++i) {
+            REQUIRE(target[i] == std::to_string(i));
+        }
+    }
+
+    SECTION("конструктор перемещения забирает блок вместе с ресурсом") {
+        const auto *data = source.data();
+        PmrVector<std::string> target(std::move(source));
+        REQUIRE(target.data() == data);
+
+        // следующий блок выделяется из того же ресурса
+        const auto allocations = first.allocations;
+        target.reserve(100);
+        REQUIRE(first.allocations == allocations + 1);
+        REQUIRE(second.allocations == 0);
+    }
+}